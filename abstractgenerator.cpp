@@ -41,6 +41,8 @@
 
 #include <ctype.h>
 #include <apr-1/apr_poll.h>
+#include <algorithm>
+#include <set>
 
 namespace DBBinder
 {
@@ -62,6 +64,8 @@ const char * const tpl_FUNCTION = "FUNCTION";
 const char * const tpl_NAMESPACES = "NAMESPACES";
 const char * const tpl_NAMESPACE = "NAMESPACE";
 
+const char * const tpl_PTIME = "PTIME";
+
 const char * const tpl_CLASS = "CLASS";
 const char * const tpl_CLASSNAME = "CLASSNAME";
 
@@ -77,6 +81,7 @@ const char * const tpl_SPROC = "SPROC";
 
 const char * const tpl_STMT_SQL = "STMT_SQL";
 const char * const tpl_STMT_SQL_UNESCAPED = "STMT_SQL_UNESCAPED";
+const char * const tpl_STMT_PREPARED_NAME = "STMT_PREPARED_NAME";
 const char * const tpl_STMT_SQL_LEN = "STMT_SQL_LEN";
 const char * const tpl_STMT_FIELD_COUNT = "STMT_FIELD_COUNT";
 const char * const tpl_STMT_PARAM_COUNT = "STMT_PARAM_COUNT";
@@ -85,6 +90,7 @@ const char * const tpl_STMT_HAS_PARAMS = "STMT_HAS_PARAMS";
 
 const char * const tpl_STMT_IN_FIELDS = "STMT_IN_FIELDS";
 const char * const tpl_STMT_IN_FIELD_TYPE = "STMT_IN_FIELD_TYPE";
+const char * const tpl_STMT_IN_FIELD_MEMBER_TYPE = "STMT_IN_FIELD_MEMBER_TYPE";
 const char * const tpl_STMT_IN_FIELD_NAME = "STMT_IN_FIELD_NAME";
 const char * const tpl_STMT_IN_FIELD_COMMA = "STMT_IN_FIELD_COMMA";
 const char * const tpl_STMT_IN_FIELD_INIT = "STMT_IN_FIELD_INIT";
@@ -100,6 +106,45 @@ const char * const tpl_STMT_OUT_FIELD_GETVALUE = "STMT_OUT_FIELD_GETVALUE";
 const char * const tpl_STMT_OUT_FIELD_ISNULL = "STMT_OUT_FIELD_ISNULL";
 const char * const tpl_STMT_OUT_FIELDS_BUFFERS = "STMT_OUT_FIELDS_BUFFERS";
 const char * const tpl_STMT_OUT_FIELD_COMMENT = "STMT_OUT_FIELD_COMMENT";
+const char * const tpl_STMT_OUT_FIELD_COLUMN_TYPE = "STMT_OUT_FIELD_COLUMN_TYPE";
+const char * const tpl_STMT_OUT_FIELD_ARROW_TYPE = "STMT_OUT_FIELD_ARROW_TYPE";
+const char * const tpl_STMT_OUT_FIELD_ARROW_BUILDER = "STMT_OUT_FIELD_ARROW_BUILDER";
+const char * const tpl_STMT_OUT_FIELD_ARROW_VALUE = "STMT_OUT_FIELD_ARROW_VALUE";
+const char * const tpl_STMT_OUT_FIELD_ARROW_READ = "STMT_OUT_FIELD_ARROW_READ";
+const char * const tpl_STMT_OUT_FIELD_ENUM = "STMT_OUT_FIELD_ENUM";
+const char * const tpl_STMT_OUT_FIELD_ENUM_TYPE = "STMT_OUT_FIELD_ENUM_TYPE";
+const char * const tpl_STMT_OUT_FIELD_ENUM_BASE = "STMT_OUT_FIELD_ENUM_BASE";
+const char * const tpl_STMT_OUT_FIELD_ENUM_VALUES = "STMT_OUT_FIELD_ENUM_VALUES";
+const char * const tpl_STMT_OUT_FIELD_ENUM_NAMES = "STMT_OUT_FIELD_ENUM_NAMES";
+const char * const tpl_STMT_OUT_FIELD_ENUM_COUNT = "STMT_OUT_FIELD_ENUM_COUNT";
+const char * const tpl_STMT_OUT_FIELD_NULL_BYTE = "STMT_OUT_FIELD_NULL_BYTE";
+const char * const tpl_STMT_OUT_FIELD_NULL_MASK = "STMT_OUT_FIELD_NULL_MASK";
+const char * const tpl_STMT_OUT_FIELDS_PACKED = "STMT_OUT_FIELDS_PACKED";
+const char * const tpl_STMT_OUT_FIELD_STREAM = "STMT_OUT_FIELD_STREAM";
+const char * const tpl_STMT_OUT_FIELD_STREAM_LENGTH = "STMT_OUT_FIELD_STREAM_LENGTH";
+const char * const tpl_STMT_OUT_FIELD_STREAM_READ = "STMT_OUT_FIELD_STREAM_READ";
+const char * const tpl_STMT_OUT_NULL_BYTES = "STMT_OUT_NULL_BYTES";
+const char * const tpl_STMT_OUT_FIELD_LAZY = "STMT_OUT_FIELD_LAZY";
+const char * const tpl_STMT_LAZY = "STMT_LAZY";
+const char * const tpl_STMT_PAGINATE = "STMT_PAGINATE";
+const char * const tpl_STMT_PAGE_SIZE = "STMT_PAGE_SIZE";
+const char * const tpl_STMT_PAGE_KEY_PARAM = "STMT_PAGE_KEY_PARAM";
+const char * const tpl_STMT_PARTITION = "STMT_PARTITION";
+const char * const tpl_STMT_IN_FIELD_SCAN_PARAM = "STMT_IN_FIELD_SCAN_PARAM";
+const char * const tpl_STMT_IN_FIELD_SCAN_ARG = "STMT_IN_FIELD_SCAN_ARG";
+const char * const tpl_PARALLEL_SCAN = "PARALLEL_SCAN";
+const char * const tpl_STMT_FETCH_ONE = "STMT_FETCH_ONE";
+const char * const tpl_STMT_SINGLE = "STMT_SINGLE";
+const char * const tpl_STMT_SCALAR = "STMT_SCALAR";
+const char * const tpl_STMT_SCALAR_TYPE = "STMT_SCALAR_TYPE";
+const char * const tpl_STMT_SCALAR_NAME = "STMT_SCALAR_NAME";
+const char * const tpl_STMT_SCALAR_TEXT = "STMT_SCALAR_TEXT";
+const char * const tpl_STMT_SCALAR_PLAIN = "STMT_SCALAR_PLAIN";
+const char * const tpl_STMT_INSERT_METHOD = "STMT_INSERT_METHOD";
+const char * const tpl_STMT_BATCH = "STMT_BATCH";
+const char * const tpl_STMT_MANY = "STMT_MANY";
+const char * const tpl_STMT_MANY_CLASSNAME = "STMT_MANY_CLASSNAME";
+const char * const tpl_STMT_IN_FIELD_LIST_TYPE = "STMT_IN_FIELD_LIST_TYPE";
 const char * const tpl_STMT_OUT_KEY_FIELD_NAME = "STMT_OUT_KEY_FIELD_NAME";
 const char * const tpl_STMT_OUT_KEY_FIELD_TYPE = "STMT_OUT_KEY_FIELD_TYPE";
 
@@ -136,6 +181,9 @@ const char * const tpl_DBENGINE_DESTROY_SELECT = "DBENGINE_DESTROY_SELECT";
 const char * const tpl_DBENGINE_RESET_SELECT = "DBENGINE_RESET_SELECT";
 const char * const tpl_DBENGINE_EXECUTE_SELECT = "DBENGINE_EXECUTE_SELECT";
 const char * const tpl_DBENGINE_FETCH_SELECT = "DBENGINE_FETCH_SELECT";
+const char * const tpl_DBENGINE_ROW_COUNT_SELECT = "DBENGINE_ROW_COUNT_SELECT";
+
+const char * const tpl_DBENGINE_BATCH_SIZE = "DBENGINE_BATCH_SIZE";
 
 const char * const tpl_DBENGINE_CREATE_UPDATE = "DBENGINE_CREATE_UPDATE";
 const char * const tpl_DBENGINE_PREPARE_UPDATE = "DBENGINE_PREPARE_UPDATE";
@@ -174,6 +222,8 @@ SQLTypes typeNameToSQLType(std::string _name)
             {
                 if ( _name == "blob" )
                     return stBlob;
+                else if ( _name == "bool" || _name == "boolean" )
+                    return stBool;
 
                 break;
             }
@@ -181,6 +231,8 @@ SQLTypes typeNameToSQLType(std::string _name)
             {
                 if ( _name == "double" )
                     return stDouble;
+                else if ( _name == "decimal" )
+                    return stDecimal;
                 else if ( _name == "date" )
                     return stDate;
                 else if ( _name == "datetime" )
@@ -202,6 +254,13 @@ SQLTypes typeNameToSQLType(std::string _name)
 
                 break;
             }
+            case 'n':
+            {
+                if ( _name == "numeric" )
+                    return stDecimal;
+
+                break;
+            }
             case 's':
             {
                 if ( _name == "str" || _name == "string" )
@@ -232,6 +291,16 @@ SQLTypes typeNameToSQLType(std::string _name)
     return stUnknown;
 }
 
+// "int[]" is a list of ints
+SQLTypes typeNameToSQLType(std::string _name, bool& _list)
+{
+    _list = _name.length() > 2 && _name.compare(_name.length() - 2, 2, "[]") == 0;
+    if ( _list )
+        _name.erase(_name.length() - 2);
+
+    return typeNameToSQLType(_name);
+}
+
 std::string sqlTypeToName(SQLTypes _type)
 {
 #define __typeToString(TYPE) case TYPE: return # TYPE ;
@@ -246,11 +315,14 @@ std::string sqlTypeToName(SQLTypes _type)
         __typeToString(stDouble);
         __typeToString(stUFloat);
         __typeToString(stUDouble);
+        __typeToString(stBool);
+        __typeToString(stDecimal);
         __typeToString(stTimeStamp);
         __typeToString(stTime);
         __typeToString(stDate);
         __typeToString(stText);
         __typeToString(stBlob);
+        __typeToString(stEnum);
     }
 #undef __typeToString
 
@@ -341,7 +413,9 @@ bool AbstractGenerator::checkConnection()
 
 std::string AbstractGenerator::getType(SQLTypes _sqlType)
 {
-    std::string result = m_types[_sqlType];
+    // find(), not [], so asking for a type doesn't record an empty override
+    mapTypes::const_iterator it = m_types.find(_sqlType);
+    std::string result = it != m_types.end() ? it->second : std::string();
 
     if ( result.empty() )
     {
@@ -392,6 +466,16 @@ std::string AbstractGenerator::getType(SQLTypes _sqlType)
                 result = "unsigned double";
                 break;
             }
+            case stBool:
+            {
+                result = "bool";
+                break;
+            }
+            case stDecimal:
+            {
+                result = "DBBinderDecimal";
+                break;
+            }
             case stTimeStamp:
             case stTime:
             case stDate:
@@ -409,12 +493,37 @@ std::string AbstractGenerator::getType(SQLTypes _sqlType)
                 result = "shared_pointer< std::vector<char> >::type";
                 break;
             }
+            case stEnum:
+            {
+                FATAL("BUG BUG BUG! Enum types are named after their column. " << __FILE__ << __LINE__);
+            }
         }
     }
 
     return result;
 }
 
+std::string AbstractGenerator::getType(const SQLElement& _element)
+{
+    // Enums are generated inside the statement class, one per column
+    if ( _element.type == stEnum )
+        return _element.name + "Enum";
+
+    return getType(_element.type);
+}
+
+// Type of a copy that outlives the call or the fetch it came from: text
+// read as a pointer into the driver's buffers is copied into a DBBinderText
+std::string AbstractGenerator::getMemberType(const SQLElement& _element)
+{
+    std::string result = getType(_element);
+
+    if ( _element.type == stText && result == "const char*" )
+        result = "DBBinderText";
+
+    return result;
+}
+
 std::string AbstractGenerator::getInit(SQLTypes _sqlType)
 {
     std::string result;
@@ -438,21 +547,230 @@ std::string AbstractGenerator::getInit(SQLTypes _sqlType)
             result = "0";
             break;
         }
+        case stBool:
+        {
+            result = "false";
+            break;
+        }
         case stDate:
         case stTime:
         case stTimeStamp:
         {
-            result = "ptime()";
+            // Nothing! The type may be replaced by setType()
+            break;
+        }
+        case stText:    // const char* or, mapped by setType(), a string class
+        case stDecimal:
+        case stBlob:
+        case stEnum:
+        {
+            // Nothing!  Use default initializer
             break;
         }
+    }
+
+    return result;
+}
+
+std::string AbstractGenerator::getColumnType(const SQLElement& _element)
+{
+    std::string result;
+
+    switch ( _element.type )
+    {
         case stText:
+        case stBlob:
+        {
+            result = "DBBinderTextColumn";
+            break;
+        }
+        default:
         {
-            result = "NULL";
+            result = "DBBinderColumn< " + getType(_element) + " >";
+            break;
+        }
+    }
+
+    return result;
+}
+
+int AbstractGenerator::getAlignment(SQLTypes _sqlType)
+{
+    // Types replaced by setType() are unknown to us, assume the worst.
+    mapTypes::const_iterator it = m_types.find(_sqlType);
+    if ( it != m_types.end() && !it->second.empty() )
+        return 8;
+
+    int result = 8;
+
+    switch ( _sqlType )
+    {
+        case stInt:
+        case stUInt:
+        case stFloat:
+        case stUFloat:
+        {
+            result = 4;
+            break;
+        }
+        case stBool:
+        {
+            result = 1;
+            break;
+        }
+        default:
+        {
+            // 64 bit numbers, ptime, pointers and smart pointers
+            break;
+        }
+    }
+
+    return result;
+}
+
+int AbstractGenerator::getAlignment(const SQLElement& _element)
+{
+    if ( _element.type == stEnum )
+        return _element.enumValues.size() > 256 ? 2 : 1;
+
+    return getAlignment(_element.type);
+}
+
+std::string AbstractGenerator::getArrowType(SQLTypes _sqlType)
+{
+    std::string result;
+
+    switch ( _sqlType )
+    {
+        case stUnknown:
+        {
+            FATAL("BUG BUG BUG! " << __FILE__ << __LINE__);
+        }
+        case stInt:
+        {
+            result = "arrow::int32()";
+            break;
+        }
+        case stUInt:
+        {
+            result = "arrow::uint32()";
+            break;
+        }
+        case stInt64:
+        {
+            result = "arrow::int64()";
+            break;
+        }
+        case stUInt64:
+        {
+            result = "arrow::uint64()";
+            break;
+        }
+        case stFloat:
+        case stUFloat:
+        {
+            result = "arrow::float32()";
+            break;
+        }
+        case stDouble:
+        case stUDouble:
+        {
+            result = "arrow::float64()";
+            break;
+        }
+        case stBool:
+        {
+            result = "arrow::boolean()";
+            break;
+        }
+        case stTimeStamp:
+        case stTime:
+        case stDate:
+        {
+            result = "arrow::timestamp(arrow::TimeUnit::MICRO)";
+            break;
+        }
+        case stDecimal: // exact, the scale may change from row to row
+        case stEnum:    // by label, the codes are only meaningful to the generated code
+        case stText:
+        {
+            result = "arrow::utf8()";
             break;
         }
         case stBlob:
         {
-            // Nothing!  Use default initializer
+            result = "arrow::binary()";
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::string AbstractGenerator::getArrowBuilder(SQLTypes _sqlType)
+{
+    std::string result;
+
+    switch ( _sqlType )
+    {
+        case stUnknown:
+        {
+            FATAL("BUG BUG BUG! " << __FILE__ << __LINE__);
+        }
+        case stInt:
+        {
+            result = "arrow::Int32Builder";
+            break;
+        }
+        case stUInt:
+        {
+            result = "arrow::UInt32Builder";
+            break;
+        }
+        case stInt64:
+        {
+            result = "arrow::Int64Builder";
+            break;
+        }
+        case stUInt64:
+        {
+            result = "arrow::UInt64Builder";
+            break;
+        }
+        case stFloat:
+        case stUFloat:
+        {
+            result = "arrow::FloatBuilder";
+            break;
+        }
+        case stDouble:
+        case stUDouble:
+        {
+            result = "arrow::DoubleBuilder";
+            break;
+        }
+        case stBool:
+        {
+            result = "arrow::BooleanBuilder";
+            break;
+        }
+        case stTimeStamp:
+        case stTime:
+        case stDate:
+        {
+            result = "arrow::TimestampBuilder";
+            break;
+        }
+        case stDecimal:
+        case stEnum:
+        case stText:
+        {
+            result = "arrow::StringBuilder";
+            break;
+        }
+        case stBlob:
+        {
+            result = "arrow::BinaryBuilder";
             break;
         }
     }
@@ -464,6 +782,8 @@ void AbstractGenerator::addSelect(SelectElements _elements)
 {
     std::string name = stringToLower( _elements.name );
 
+    bool keyFound = false;
+
     if (!_elements.keyFieldName.empty())
     {
         std::string key = _elements.keyFieldName;
@@ -475,6 +795,7 @@ void AbstractGenerator::addSelect(SelectElements _elements)
         if (endptr && (*endptr == '\0' || isblank(*endptr) || *endptr == '\n'))
         {
             _elements.keyField = index - 1;
+            keyFound = _elements.keyField >= 0 && _elements.keyField < static_cast<int>(_elements.output.size());
         }
         else
         {
@@ -485,12 +806,100 @@ void AbstractGenerator::addSelect(SelectElements _elements)
                 if (strcasecmp(it->name.c_str(), key.c_str()) == 0)
                 {
                     _elements.keyField = it->index;
+                    keyFound = true;
                     break;
                 }
             }
         }
     }
 
+    if (_elements.pageSize > 0)
+    {
+        if (!keyFound)
+            FATAL(_elements.name << ": unknown paginate key field '" << _elements.keyFieldName << "'");
+
+        // The next page starts after the last key of this one, so the key
+        // is copied out of the row into the saved params
+        const SQLElement &key = _elements.output.at(_elements.keyField);
+        if (key.type == stBlob)
+            FATAL(_elements.name << ": paginate key field '" << key.name << "' must not be a blob field");
+
+        ListElements::const_iterator it = _elements.input.begin(), end = _elements.input.end();
+        for(; it != end; ++it)
+        {
+            if (strcasecmp(it->name.c_str(), key.name.c_str()) == 0)
+                break;
+        }
+
+        if (it == end)
+            FATAL(_elements.name << ": paginate needs a param named '" << key.name << "' for the last key of the previous page");
+
+        if (it->list)
+            FATAL(_elements.name << ": paginate param '" << it->name << "' must not be a list");
+
+        _elements.pageKeyParam = it->name;
+    }
+
+    if (!_elements.partitionLow.empty())
+    {
+        if (!keyFound)
+            FATAL(_elements.name << ": unknown partition key field '" << _elements.keyFieldName << "'");
+
+        // Key ranges are split arithmetically
+        const SQLElement &key = _elements.output.at(_elements.keyField);
+        if (key.type != stInt && key.type != stUInt && key.type != stInt64 && key.type != stUInt64)
+            FATAL(_elements.name << ": partition key field '" << key.name << "' must be an integer field");
+
+        std::string *bounds[] = { &_elements.partitionLow, &_elements.partitionHigh };
+        for (int i = 0; i < 2; ++i)
+        {
+            ListElements::const_iterator it = _elements.input.begin(), end = _elements.input.end();
+            for(; it != end; ++it)
+            {
+                if (strcasecmp(it->name.c_str(), bounds[i]->c_str()) == 0)
+                    break;
+            }
+
+            if (it == end)
+                FATAL(_elements.name << ": unknown partition param '" << *bounds[i] << "'");
+
+            if (it->list)
+                FATAL(_elements.name << ": partition param '" << it->name << "' must not be a list");
+
+            *bounds[i] = it->name;
+        }
+    }
+
+    if (_elements.scalar && _elements.output.size() > 1)
+        WARNING(_elements.name << ": scalar select returns " << _elements.output.size() << " columns, value() only reads the first");
+
+    for(ListString::const_iterator field = _elements.streamFieldNames.begin(); field != _elements.streamFieldNames.end(); ++field)
+    {
+        ListElements::iterator it = _elements.output.begin(), end = _elements.output.end();
+        int index = 0;
+
+        for(; it != end; ++it, ++index)
+        {
+            if (strcasecmp(it->name.c_str(), field->c_str()) == 0)
+                break;
+        }
+
+        if (it == end)
+        {
+            WARNING(_elements.name << ": unknown stream field '" << *field << "'");
+        }
+        else if (it->type != stText && it->type != stBlob)
+        {
+            WARNING(_elements.name << ": stream field '" << *field << "' is not a text or blob field");
+        }
+        else if (getStreamRead(it, index).empty())
+        {
+            WARNING(_elements.name << ": this database engine can't stream field '" << *field << "'");
+        }
+        else
+            it->streamed = true;
+    }
+
     _classParamsPtr params = m_classParams[ name ];
 
     if ( !params )
@@ -511,6 +920,14 @@ void AbstractGenerator::addUpdate(UpdateElements _elements)
 
     params->update = _elements;
     m_classParams[ name ] = params;
+
+    // Engines check the set-based rewrite as any other update
+    UpdateElements many;
+    if ( setManyElements( _elements, many ))
+    {
+        addUpdate( many );
+        params->updateMany = many.name;
+    }
 }
 
 void AbstractGenerator::addInsert(InsertElements _elements)
@@ -526,6 +943,266 @@ void AbstractGenerator::addInsert(InsertElements _elements)
     m_classParams[ name ] = params;
 }
 
+// Case insensitive match of _word at _pos, not followed by more of an identifier
+static bool matchWord(const std::string& _sql, std::string::size_type _pos, const char *_word)
+{
+    size_t len = strlen( _word );
+    return strncasecmp( _sql.c_str() + _pos, _word, len ) == 0 &&
+           !(isalnum( _sql[_pos + len] ) || _sql[_pos + len] == '_');
+}
+
+static std::string::size_type skipSpaces(const std::string& _sql, std::string::size_type _pos)
+{
+    while ( _pos < _sql.size() && isspace( _sql[_pos] ))
+        ++_pos;
+    return _pos;
+}
+
+// Splits the "(a, b, ...)" at _pos on its top level commas, leaving _pos after the ')'
+static bool splitParenthesized(const std::string& _sql, std::string::size_type& _pos, ListString& _items)
+{
+    if ( _pos >= _sql.size() || _sql[_pos] != '(' )
+        return false;
+
+    int depth = 0;
+    char quote = 0;
+    std::string::size_type start = _pos + 1;
+
+    for (; _pos < _sql.size(); ++_pos)
+    {
+        char c = _sql[_pos];
+        if ( quote )
+        {
+            if ( c == quote )
+                quote = 0;
+        }
+        else if ( c == '\'' || c == '"' || c == '`' )
+            quote = c;
+        else if ( c == '(' )
+            ++depth;
+        else if ( c == ')' && depth > 1 )
+            --depth;
+        else if ( c == ')' || (c == ',' && depth == 1) )
+        {
+            std::string::size_type end = _pos, begin = skipSpaces( _sql, start );
+            while ( end > begin && isspace( _sql[end - 1] ))
+                --end;
+            _items.push_back( _sql.substr( begin, end - begin ));
+            start = _pos + 1;
+
+            if ( c == ')' )
+            {
+                ++_pos;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Reads "INSERT INTO table (columns) VALUES (values)", the only form an upsert is written in
+static bool splitInsertSQL(const std::string& _sql, std::string& _table, ListString& _columns, ListString& _values)
+{
+    std::string::size_type pos = skipSpaces( _sql, 0 );
+    if ( !matchWord( _sql, pos, "insert" ))
+        return false;
+
+    pos = skipSpaces( _sql, pos + 6 );
+    if ( !matchWord( _sql, pos, "into" ))
+        return false;
+
+    pos = skipSpaces( _sql, pos + 4 );
+    std::string::size_type start = pos;
+    while ( pos < _sql.size() && !isspace( _sql[pos] ) && _sql[pos] != '(' )
+        ++pos;
+    _table = _sql.substr( start, pos - start );
+
+    pos = skipSpaces( _sql, pos );
+    if ( _table.empty() || !splitParenthesized( _sql, pos, _columns ))
+        return false;
+
+    pos = skipSpaces( _sql, pos );
+    if ( !matchWord( _sql, pos, "values" ))
+        return false;
+
+    pos = skipSpaces( _sql, pos + 6 );
+    if ( !splitParenthesized( _sql, pos, _values ) || _values.size() != _columns.size() )
+        return false;
+
+    pos = skipSpaces( _sql, pos );
+    if ( pos < _sql.size() && _sql[pos] == ';' )
+        pos = skipSpaces( _sql, pos + 1 );
+
+    return pos == _sql.size();
+}
+
+void AbstractGenerator::addUpsert(InsertElements _elements)
+{
+    std::string table;
+    ListString columns, values;
+
+    _elements.type = sstUpsert;
+    if ( !splitInsertSQL( _elements.sql, table, columns, values ))
+        FATAL(_elements.name << ": upsert must be written as INSERT INTO table (columns) VALUES (values)");
+
+    ListString updates;
+    for (ListString::const_iterator it = columns.begin(); it != columns.end(); ++it)
+    {
+        ListString::const_iterator key;
+        for (key = _elements.conflictKeys.begin(); key != _elements.conflictKeys.end(); ++key)
+            if (strcasecmp(it->c_str(), key->c_str()) == 0)
+                break;
+
+        if ( key == _elements.conflictKeys.end() )
+            updates.push_back( *it );
+    }
+
+    if ( columns.size() - updates.size() != _elements.conflictKeys.size() )
+        FATAL(_elements.name << ": upsert keys must be distinct inserted columns");
+
+    std::string sql = getUpsertSQL( table, columns, values, _elements.conflictKeys, updates );
+    if ( sql.empty() )
+        FATAL(_elements.name << ": this database engine can't generate upserts");
+
+    _elements.sql = sql;
+
+    // Engines check the rewritten statement as any other insert
+    addInsert( _elements );
+}
+
+// Reads "UPDATE table SET c = ?, ... WHERE k = ? AND ..." or, without _columns,
+// "DELETE FROM table WHERE k = ? AND ...": the only forms updateMany() and
+// delMany() rewrite.  _values and _keyValues get the placeholders as written
+static bool splitKeyedSQL(const std::string& _sql, bool _update, std::string& _table, ListString& _columns,
+                          ListString& _values, ListString& _keys, ListString& _keyValues)
+{
+    std::string::size_type pos = skipSpaces( _sql, 0 );
+    if ( !matchWord( _sql, pos, _update ? "update" : "delete" ))
+        return false;
+
+    pos = skipSpaces( _sql, pos + 6 );
+    if ( !_update )
+    {
+        if ( !matchWord( _sql, pos, "from" ))
+            return false;
+        pos = skipSpaces( _sql, pos + 4 );
+    }
+
+    std::string::size_type start = pos;
+    while ( pos < _sql.size() && !isspace( _sql[pos] ))
+        ++pos;
+    _table = _sql.substr( start, pos - start );
+
+    // SET assignments are separated by commas, WHERE matches by AND
+    bool where = !_update;
+    pos = skipSpaces( _sql, pos );
+    if ( !matchWord( _sql, pos, where ? "where" : "set" ))
+        return false;
+    pos += where ? 5 : 3;
+
+    for (;;)
+    {
+        ListString& columns = where ? _keys : _columns;
+        ListString& values = where ? _keyValues : _values;
+
+        pos = skipSpaces( _sql, pos );
+        start = pos;
+        while ( pos < _sql.size() && !isspace( _sql[pos] ) && _sql[pos] != '=' )
+            ++pos;
+        columns.push_back( _sql.substr( start, pos - start ));
+
+        pos = skipSpaces( _sql, pos );
+        if ( columns.back().empty() || pos >= _sql.size() || _sql[pos] != '=' )
+            return false;
+
+        pos = skipSpaces( _sql, pos + 1 );
+        start = pos;
+        while ( pos < _sql.size() && !isspace( _sql[pos] ) && _sql[pos] != ',' && _sql[pos] != ';' )
+            ++pos;
+        values.push_back( _sql.substr( start, pos - start ));
+
+        pos = skipSpaces( _sql, pos );
+        if ( pos >= _sql.size() || _sql[pos] == ';' )
+            break;
+
+        if ( !where && _sql[pos] == ',' )
+            ++pos;
+        else if ( where && matchWord( _sql, pos, "and" ))
+            pos += 3;
+        else if ( !where && matchWord( _sql, pos, "where" ))
+        {
+            pos += 5;
+            where = true;
+        }
+        else
+            return false;
+    }
+
+    if ( pos < _sql.size() )
+        pos = skipSpaces( _sql, pos + 1 );
+
+    return pos == _sql.size() && !_table.empty() && !_keys.empty();
+}
+
+// The set-based form of an update or delete, run by updateMany()/delMany():
+// each param is a list holding one value per element
+bool AbstractGenerator::setManyElements(const AbstractElements& _elements, AbstractElements& _many)
+{
+    std::string table;
+    ListString columns, values, keys, keyValues;
+
+    if ( _elements.input.empty() ||
+         !splitKeyedSQL( _elements.sql, _elements.type == sstUpdate, table, columns, values, keys, keyValues ))
+        return false;
+
+    // "?" markers count up, "?N" and "$N" name their param; each one is used once
+    values.insert( values.end(), keyValues.begin(), keyValues.end() );
+
+    std::vector<int> params;
+    std::vector<bool> used( _elements.input.size(), false );
+    int next = 0;
+
+    for (ListString::const_iterator it = values.begin(); it != values.end(); ++it)
+    {
+        int index = next++;
+        if ( it->size() > 1 && ((*it)[0] == '?' || (*it)[0] == '$') &&
+             it->find_first_not_of( "0123456789", 1 ) == std::string::npos )
+            index = atoi( it->c_str() + 1 ) - 1;
+        else if ( *it != "?" )
+            return false;
+
+        if ( index < 0 || index >= int(used.size()) || used[index] )
+            return false;
+
+        used[index] = true;
+        params.push_back( index );
+    }
+
+    if ( params.size() != used.size() )
+        return false;
+
+    // Lists can only hold what list params do
+    _many.input = _elements.input;
+    for (ListElements::iterator it = _many.input.begin(); it != _many.input.end(); ++it)
+    {
+        if ( it->list || it->type == stDecimal || it->type == stBlob || it->type == stEnum ||
+             it->type == stTimeStamp || it->type == stTime || it->type == stDate )
+            return false;
+
+        it->list = true;
+    }
+
+    _many.sql = getManySQL( table, columns, keys, params, _many.input );
+    if ( _many.sql.empty() )
+        return false;
+
+    _many.name = _elements.name + (_elements.type == sstUpdate ? "UpdateMany" : "DelMany");
+    _many.sql_location = _elements.sql_location;
+    _many.allowScan = _elements.allowScan;
+
+    return true;
+}
+
 void AbstractGenerator::addDelete(DeleteElements _elements)
 {
     std::string name = stringToLower( _elements.name );
@@ -537,6 +1214,13 @@ void AbstractGenerator::addDelete(DeleteElements _elements)
 
     params->del = _elements;
     m_classParams[ name ] = params;
+
+    DeleteElements many;
+    if ( setManyElements( _elements, many ))
+    {
+        addDelete( many );
+        params->delMany = many.name;
+    }
 }
 
 void AbstractGenerator::addStoredProcedure(StoredProcedureElements _elements)
@@ -583,6 +1267,9 @@ void AbstractGenerator::generate()
     if ( DBBinder::optListDepends )
         return;
 
+    if ( !optPlanCheck.empty() )
+        writeQueryPlans();
+
     std::string str;
     {
         std::ofstream out( m_outIntFile.c_str(), std::ios_base::trunc );
@@ -645,6 +1332,75 @@ void AbstractGenerator::generate()
     str.clear();
 }
 
+static const char* statementName(SQLStatementTypes _type)
+{
+    switch ( _type )
+    {
+        case sstSelect:             return "select";
+        case sstInsert:             return "insert";
+        case sstUpdate:             return "update";
+        case sstDelete:             return "delete";
+        case sstStoredProcedure:    return "call";
+        case sstUpsert:             return "upsert";
+        default:                    return "unknown";
+    }
+}
+
+void AbstractGenerator::checkQueryPlan(const AbstractElements& _elements, const std::string& _plan, const ListString& _scans)
+{
+    m_queryPlans[_elements.name + ' ' + statementName(_elements.type)] = _plan;
+
+    if ( _scans.empty() || _elements.allowScan )
+        return;
+
+    std::stringstream msg;
+    msg << _elements.sql_location.file << ':' << _elements.sql_location.line << ": " << _elements.name
+        << " does a full table scan (add '--! scan' if that is intended):";
+
+    foreach(const std::string& scan, _scans)
+        msg << "\n    " << scan;
+
+    if ( optPlanCheck == "error" )
+        FATAL(msg.str());
+
+    WARNING(msg.str());
+}
+
+void AbstractGenerator::writeQueryPlans()
+{
+    // Each plan is a "-- <name> <statement>" line followed by the engine's own plan text
+    const std::string fileName = optOutput + ".plan";
+
+    // Compare with the last run, so a plan that lost its index doesn't go unnoticed
+    {
+        std::ifstream in( fileName.c_str() );
+        std::string line, name, plan;
+        bool more = true;
+
+        while ( more )
+        {
+            more = !std::getline(in, line).fail();
+
+            if ( !more || line.compare(0, 3, "-- ") == 0 )
+            {
+                mapPlans::const_iterator it = m_queryPlans.find(name);
+                if ( it != m_queryPlans.end() && it->second != plan )
+                    WARNING(fileName << ": the query plan for " << name << " changed:\n" << plan << "is now:\n" << it->second);
+
+                name = more ? line.substr(3) : "";
+                plan.clear();
+            }
+            else if ( !line.empty() )
+                plan += line + '\n';
+        }
+    }
+
+    std::ofstream out( fileName.c_str(), std::ios_base::trunc );
+
+    for(mapPlans::const_iterator it = m_queryPlans.begin(); it != m_queryPlans.end(); ++it)
+        out << "-- " << it->first << '\n' << it->second << '\n';
+}
+
 void AbstractGenerator::loadDatabase()
 {
     TemplateDictionary *subDict = NULL;
@@ -848,6 +1604,19 @@ bool AbstractGenerator::loadXMLDatabase(const std::string& _path)
                         m_dict->SetValue(tpl_DBENGINE_DISCONNECT, parseStringVariables(node->ToElement()->GetText()));
                     }
 
+                    // Engines that can't tell how many rows a select returned don't reserve
+                    m_dict->SetValue(tpl_DBENGINE_ROW_COUNT_SELECT, "return 0;");
+
+                    // Elements per updateMany()/delMany() statement
+                    m_dict->SetIntValue(tpl_DBENGINE_BATCH_SIZE, 1000);
+
+                    node = 0;
+                    while( node = lang->IterateChildren( "batch", node ))
+                    {
+                        str = node->ToElement()->GetAttributeOrDefault( "size", "" );
+                        if ( !str.empty() ) m_dict->SetValue(tpl_DBENGINE_BATCH_SIZE, str);
+                    }
+
                     node = 0;
                     while( node = lang->IterateChildren( "select", node ))
                     {
@@ -866,6 +1635,9 @@ bool AbstractGenerator::loadXMLDatabase(const std::string& _path)
                         elem = node->FirstChildElement("fetch", false);
                         if ( elem ) m_dict->SetValue(tpl_DBENGINE_FETCH_SELECT, parseStringVariables(elem->GetText(false)));
 
+                        elem = node->FirstChildElement("row_count", false);
+                        if ( elem ) m_dict->SetValue(tpl_DBENGINE_ROW_COUNT_SELECT, parseStringVariables(elem->GetText(false)));
+
                         elem = node->FirstChildElement("reset", false);
                         if ( elem ) m_dict->SetValue(tpl_DBENGINE_RESET_SELECT, parseStringVariables(elem->GetText(false)));
                     }
@@ -1127,6 +1899,20 @@ bool AbstractGenerator::loadXMLTemplate(const std::string & _path)
             }
         }
 
+        XMLNodePtr node = 0;
+        while( node = xml->IterateChildren( "section", node ))
+        {
+            std::string section;
+            node->ToElement()->GetAttribute("name", &section, false);
+
+            if ( section.empty() )
+            {
+                WARNING("XML: " << _path << ": <section> without a name");
+            }
+            else
+                m_templSections.push_back( section );
+        }
+
         return true;
     }
     catch( ticpp::Exception &e )
@@ -1142,6 +1928,78 @@ bool AbstractGenerator::loadYAMLTemplate(const std::string & _path)
     DBBinder::optDepends.push_back( _path );
 }
 
+typedef std::pair<int, ListElements::iterator> AlignedElement;
+
+static bool alignmentGreater(const AlignedElement& _a, const AlignedElement& _b)
+{
+    return _a.first > _b.first;
+}
+
+// C++ keywords, plus "type": the C++03 fallback declares its enum under that name
+static bool isCppKeyword(const std::string& _name)
+{
+    static const char * const KEYWORDS[] = { "and", "auto", "bool", "break", "case", "catch", "char", "class", "const",
+        "continue", "default", "delete", "do", "double", "else", "enum", "explicit", "extern", "false", "float", "for",
+        "friend", "goto", "if", "inline", "int", "long", "namespace", "new", "not", "operator", "or", "private",
+        "protected", "public", "register", "return", "short", "signed", "sizeof", "static", "struct", "switch",
+        "template", "this", "throw", "true", "try", "typedef", "typename", "union", "unsigned", "using", "virtual",
+        "void", "volatile", "while", "xor", "type", 0 };
+
+    for (int i = 0; KEYWORDS[i]; ++i)
+        if (_name == KEYWORDS[i])
+            return true;
+
+    return false;
+}
+
+// Turns an enum label into an enumerator name: "in progress" -> in_progress, "1st" -> _1st
+static std::string enumIdentifier(const std::string& _label)
+{
+    std::string result;
+
+    for (std::string::size_type i = 0; i < _label.length(); ++i)
+        result += isalnum(static_cast<unsigned char>(_label[i])) ? _label[i] : '_';
+
+    if (result.empty() || isdigit(static_cast<unsigned char>(result[0])))
+        result.insert(0, "_");
+    else if (isCppKeyword(result))
+        result += '_';
+
+    return result;
+}
+
+void AbstractGenerator::setEnumDictionary(TemplateDictionary *_dict, const SQLElement& _element)
+{
+    if (_element.enumValues.empty())
+        FATAL(_element.name << ": enum column without values.");
+
+    std::stringstream values, names;
+    std::set<std::string> used;
+
+    for (size_t i = 0; i < _element.enumValues.size(); ++i)
+    {
+        std::string id = enumIdentifier(_element.enumValues[i]);
+
+        // Labels that only differ in punctuation would clash
+        if (!used.insert(id).second)
+        {
+            std::stringstream unique;
+            unique << id << '_' << i;
+            id = unique.str();
+            used.insert(id);
+        }
+
+        values << (i ? ",\n" : "") << id;
+        names << (i ? ", " : "") << '"' << cescape(_element.enumValues[i]) << '"';
+    }
+
+    _dict->SetValue(tpl_STMT_OUT_FIELD_ENUM_TYPE, getType(_element));
+    _dict->SetValue(tpl_STMT_OUT_FIELD_ENUM_BASE, _element.enumValues.size() > 256 ? "uint16_t" : "uint8_t");
+    _dict->SetValue(tpl_STMT_OUT_FIELD_ENUM_VALUES, values.str());
+    _dict->SetValue(tpl_STMT_OUT_FIELD_ENUM_NAMES, names.str());
+    _dict->SetIntValue(tpl_STMT_OUT_FIELD_ENUM_COUNT, _element.enumValues.size());
+}
+
 TemplateDictionary* AbstractGenerator::setDictionaryElements(const char *_section, TemplateDictionary *_classDict, AbstractElements *_elements, SQLElement *_keyField)
 {
     TemplateDictionary *subDict;
@@ -1150,6 +2008,7 @@ TemplateDictionary* AbstractGenerator::setDictionaryElements(const char *_sectio
     _classDict->SetValue(tpl_CLASSNAME, _elements->name);
     
     TemplateDictionary *result = _classDict->AddSectionDictionary(_section);
+    showTemplSections(result);
 
     str = std::string("\"") + cescape(_elements->sql) + std::string("\"");
     _classDict->SetValue(tpl_STMT_SQL, str);
@@ -1158,6 +2017,36 @@ TemplateDictionary* AbstractGenerator::setDictionaryElements(const char *_sectio
     _classDict->SetIntValue(tpl_STMT_FIELD_COUNT, _elements->output.size());
     _classDict->SetValue(tpl_STMT_SQL_UNESCAPED, _elements->sql);
 
+    // Prepared statements live on the connection, which headers generated
+    // in other namespaces may share: the name is qualified with them, and
+    // hashed when longer than PostgreSQL keeps (63 bytes)
+    std::string preparedName;
+    for (ListString::const_iterator ns = m_namespaces.begin(); ns != m_namespaces.end(); ++ns)
+        preparedName += *ns + "::";
+    preparedName += _elements->name + '.' + statementName(_elements->type);
+
+    if (preparedName.size() > 63)
+    {
+        unsigned long long hash = 14695981039346656037ULL;  // FNV-1a
+        for (std::string::const_iterator c = preparedName.begin(); c != preparedName.end(); ++c)
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+
+        std::ostringstream hashed;
+        hashed << "dbbinder_" << std::hex << hash;
+        preparedName = hashed.str();
+    }
+    result->SetValue(tpl_STMT_PREPARED_NAME, "\"" + cescape(preparedName) + "\"");
+
+    // Stored procedures share SelectElements but not the select-only templates
+    SelectElements *select = _elements->type == sstSelect ? static_cast<SelectElements*>(_elements) : NULL;
+    bool partition = select && !select->partitionLow.empty();
+
+    if (partition)
+    {
+        _classDict->ShowSection(tpl_STMT_PARTITION);
+        m_dict->ShowSection(tpl_PARALLEL_SCAN);
+    }
+
     int index = 0;
     subDict = 0;
     ListElements::iterator elit;
@@ -1169,11 +2058,39 @@ TemplateDictionary* AbstractGenerator::setDictionaryElements(const char *_sectio
         for (elit = _elements->input.begin(); elit != _elements->input.end(); ++elit, ++index)
         {
             subDict = _classDict->AddSectionDictionary(tpl_STMT_IN_FIELDS);
-            subDict->SetValue(tpl_STMT_IN_FIELD_TYPE, getType(elit->type));
+
+            // Lists are taken by reference; the *_args structs and the saved
+            // page params keep a copy, text included
+            if (elit->list)
+            {
+                if (elit->type == stDecimal || elit->type == stBlob || elit->type == stEnum ||
+                    elit->type == stTimeStamp || elit->type == stTime || elit->type == stDate)
+                    FATAL(_elements->name << ": list param '" << elit->name << "' must be a list of numbers, booleans or text");
+
+                subDict->SetValue(tpl_STMT_IN_FIELD_TYPE, "const std::vector< " + getType(elit->type) + " >&");
+                subDict->SetValue(tpl_STMT_IN_FIELD_MEMBER_TYPE, "std::vector< " + getType(elit->type) + " >");
+            }
+            else
+            {
+                subDict->SetValue(tpl_STMT_IN_FIELD_TYPE, getType(elit->type));
+                subDict->SetValue(tpl_STMT_IN_FIELD_MEMBER_TYPE, getMemberType(*elit));
+                subDict->SetValue(tpl_STMT_IN_FIELD_LIST_TYPE, getType(elit->type));
+            }
             subDict->SetValue(tpl_STMT_IN_FIELD_NAME, elit->name);
             subDict->SetValue(tpl_STMT_IN_FIELD_COMMA, ",");
             subDict->SetValue(tpl_STMT_IN_FIELD_INIT, getInit(elit->type));
-            subDict->SetValue(tpl_STMT_IN_FIELD_BIND, getBind(sstSelect, elit, index));
+            subDict->SetValue(tpl_STMT_IN_FIELD_BIND, getBind(_elements->type == sstUpsert ? sstInsert : _elements->type, elit, index));
+
+            // parallelScan() passes each partition's bounds, the rest as given
+            if (partition && elit->name == select->partitionLow)
+                subDict->SetValue(tpl_STMT_IN_FIELD_SCAN_ARG, "from");
+            else if (partition && elit->name == select->partitionHigh)
+                subDict->SetValue(tpl_STMT_IN_FIELD_SCAN_ARG, "to");
+            else
+            {
+                subDict->SetValue(tpl_STMT_IN_FIELD_SCAN_ARG, "_" + elit->name);
+                subDict->ShowSection(tpl_STMT_IN_FIELD_SCAN_PARAM);
+            }
         }
 
         if (subDict)
@@ -1183,34 +2100,157 @@ TemplateDictionary* AbstractGenerator::setDictionaryElements(const char *_sectio
     index = 0;
     subDict = 0;
 
+    bool lazy = select && select->lazy;
+    if (lazy)
+        _classDict->ShowSection(tpl_STMT_LAZY);
+
+    if (select && (select->single || select->scalar))
+    {
+        _classDict->ShowSection(tpl_STMT_FETCH_ONE);
+
+        if (select->single)
+            _classDict->ShowSection(tpl_STMT_SINGLE);
+
+        if (select->scalar && !select->output.empty())
+        {
+            TemplateDictionary *scalarDict = _classDict->AddSectionDictionary(tpl_STMT_SCALAR);
+            std::string scalarType = getType(select->output.front());
+
+            // value()'s row is gone once it returns, so text is handed back
+            // as a copy
+            if (scalarType == "const char*")
+            {
+                scalarType = "std::string";
+                scalarDict->ShowSection(tpl_STMT_SCALAR_TEXT);
+            }
+            else
+                scalarDict->ShowSection(tpl_STMT_SCALAR_PLAIN);
+
+            scalarDict->SetValue(tpl_STMT_SCALAR_TYPE, scalarType);
+            scalarDict->SetValue(tpl_STMT_SCALAR_NAME, select->output.front().name);
+        }
+    }
+
+    if (select && select->pageSize > 0)
+    {
+        TemplateDictionary *pageDict = _classDict->AddSectionDictionary(tpl_STMT_PAGINATE);
+        pageDict->SetIntValue(tpl_STMT_PAGE_SIZE, select->pageSize);
+        pageDict->SetValue(tpl_STMT_PAGE_KEY_PARAM, select->pageKeyParam);
+    }
+
     if (_elements->output.size())
     {
+        // Stored procedures read their results through their own statement
+        SQLStatementTypes readType = _elements->type;
+
         for (elit = _elements->output.begin(); elit != _elements->output.end(); ++elit, ++index)
         {
             subDict = _classDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS);
-            subDict->SetValue(tpl_STMT_OUT_FIELD_TYPE, getType(elit->type));
+            subDict->SetValue(tpl_STMT_OUT_FIELD_TYPE, getType(*elit));
             subDict->SetValue(tpl_STMT_OUT_FIELD_NAME, elit->name);
             subDict->SetValue(tpl_STMT_OUT_FIELD_COMMA, ",");
             subDict->SetValue(tpl_STMT_OUT_FIELD_INIT, getInit(elit->type));
-            subDict->SetValue(tpl_STMT_OUT_FIELD_GETVALUE, getReadValue(sstSelect, elit, index));
-            subDict->SetValue(tpl_STMT_OUT_FIELD_ISNULL, getIsNull(sstSelect, elit, index));
+
+            if (elit->streamed)
+            {
+                // Streamed fields stay in the driver; the row only keeps the null flag
+                TemplateDictionary *streamDict = subDict->AddSectionDictionary(tpl_STMT_OUT_FIELD_STREAM);
+                streamDict->SetValue(tpl_STMT_OUT_FIELD_STREAM_LENGTH, getStreamLength(elit, index));
+                streamDict->SetValue(tpl_STMT_OUT_FIELD_STREAM_READ, getStreamRead(elit, index));
+            }
+            else if (lazy)
+            {
+                // Only the lazy section sees the read code, so the row
+                // constructor leaves the column to its decode method
+                TemplateDictionary *lazyDict = subDict->AddSectionDictionary(tpl_STMT_OUT_FIELD_LAZY);
+                lazyDict->SetValue(tpl_STMT_OUT_FIELD_GETVALUE, getReadValue(readType, elit, index));
+            }
+            else
+                subDict->SetValue(tpl_STMT_OUT_FIELD_GETVALUE, getReadValue(readType, elit, index));
+
+            subDict->SetValue(tpl_STMT_OUT_FIELD_ISNULL, getIsNull(readType, elit, index));
             subDict->SetValue(tpl_STMT_OUT_FIELD_COMMENT, elit->comment);
+            subDict->SetValue(tpl_STMT_OUT_FIELD_COLUMN_TYPE, getColumnType(*elit));
+            subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_TYPE, getArrowType(elit->type));
+            subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_BUILDER, getArrowBuilder(elit->type));
+
+            // Arrow reads straight from the driver: the engine's read code,
+            // written for a row member, decodes into a local of the same name
+            if (elit->streamed)
+            {
+                subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_READ,
+                                  "stream" + elit->name + ".resize(length" + elit->name + "());\n"
+                                  "if (!stream" + elit->name + ".empty())\n"
+                                  "    read" + elit->name + "(&stream" + elit->name + "[0], stream" + elit->name + ".size(), 0);");
+                subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_VALUE, "stream" + elit->name);
+            }
+            else
+            {
+                std::string type = getType(*elit);
+                std::string init = getInit(elit->type);
+                std::string decl = type + " m_" + elit->name;
+
+                if (!init.empty())
+                    decl += " = " + init;
+                else if (elit->type == stEnum)
+                    decl += " = " + type + "()";
+                else if (type == "const char*")
+                    decl += " = NULL";
+
+                subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_READ, decl + ";\n" + getReadValue(readType, elit, index));
+                subDict->SetValue(tpl_STMT_OUT_FIELD_ARROW_VALUE, elit->type == stEnum ? "toString(m_" + elit->name + ")" : "m_" + elit->name);
+            }
+
+            if (elit->type == stEnum)
+                setEnumDictionary(subDict->AddSectionDictionary(tpl_STMT_OUT_FIELD_ENUM), *elit);
+            subDict->SetIntValue(tpl_STMT_OUT_FIELD_NULL_BYTE, index / 8);
+            subDict->SetIntValue(tpl_STMT_OUT_FIELD_NULL_MASK, 1 << (index % 8));
         }
 
         if (subDict)
             subDict->SetValue(tpl_STMT_OUT_FIELD_COMMA, "");
+
+        // Row members are declared widest first, so there is no padding
+        // between them; the null flags are packed in a trailing bitmap.
+        std::vector<AlignedElement> packed;
+        for (elit = _elements->output.begin(); elit != _elements->output.end(); ++elit)
+            packed.push_back( AlignedElement(getAlignment(*elit), elit) );
+
+        std::stable_sort(packed.begin(), packed.end(), alignmentGreater);
+
+        for (std::vector<AlignedElement>::iterator it = packed.begin(); it != packed.end(); ++it)
+        {
+            subDict = _classDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS_PACKED);
+            subDict->SetValue(tpl_STMT_OUT_FIELD_TYPE, getMemberType(*it->second));
+            subDict->SetValue(tpl_STMT_OUT_FIELD_NAME, it->second->name);
+            subDict->SetValue(tpl_STMT_OUT_FIELD_INIT, getInit(it->second->type));
+
+            if (lazy && !it->second->streamed)
+                subDict->ShowSection(tpl_STMT_OUT_FIELD_LAZY);
+        }
+
+        _classDict->SetIntValue(tpl_STMT_OUT_NULL_BYTES, (_elements->output.size() + 7) / 8);
     }
 
     if (_keyField)
     {
         _classDict->SetValue(tpl_STMT_OUT_KEY_FIELD_NAME, _keyField->name);
-        _classDict->SetValue(tpl_STMT_OUT_KEY_FIELD_TYPE, getType(_keyField->type));
+        _classDict->SetValue(tpl_STMT_OUT_KEY_FIELD_TYPE, getType(*_keyField));
     }
     
     return result;
 }
 
 
+void AbstractGenerator::showTemplSections(TemplateDictionary *_dict)
+{
+    // A section shown in a parent dictionary does not see the values of the
+    // class/statement it is used in, so show it in every level.
+    std::string str;
+    foreach(str, m_templSections)
+        _dict->ShowSection(str);
+}
+
 void AbstractGenerator::loadDictionary()
 {
     std::string str;
@@ -1235,11 +2275,18 @@ void AbstractGenerator::loadDictionary()
     foreach(str, m_headers)
         m_dict->SetValueAndShowSection(tpl_EXTRA_HEADERS_HEADER, str, tpl_EXTRA_HEADERS);
 
+    // boost::date_time is only included while a time type is still ptime
+    if ( getType(stTimeStamp) == "ptime" || getType(stDate) == "ptime" || getType(stTime) == "ptime" )
+        m_dict->ShowSection(tpl_PTIME);
+
+    showTemplSections(m_dict);
+
     TemplateDictionary *classDict;
     classParams::iterator it;
     for(it = m_classParams.begin(); it != m_classParams.end(); ++it)
     {
         classDict = m_dict->AddSectionDictionary(tpl_CLASS);
+        showTemplSections(classDict);
 
         // ----- SELECT -----
         if ( !(it->second->select.sql.empty() ))
@@ -1260,6 +2307,7 @@ void AbstractGenerator::loadDictionary()
         {
             AbstractElements *elements = &it->second->insert;
             TemplateDictionary *subDict = setDictionaryElements(tpl_INSERT, classDict, elements, NULL);
+            subDict->SetValue(tpl_STMT_INSERT_METHOD, elements->type == sstUpsert ? "upsert" : "insert");
             
             if (needIOBuffers())
                 addInBuffers(sstInsert, subDict, elements);
@@ -1273,6 +2321,9 @@ void AbstractGenerator::loadDictionary()
             
             if (needIOBuffers())
                 addInBuffers(sstUpdate, subDict, elements);
+
+            if (!it->second->updateMany.empty())
+                subDict->SetValueAndShowSection(tpl_STMT_MANY_CLASSNAME, it->second->updateMany, tpl_STMT_MANY);
         }
         
         // ----- DELETE -----
@@ -1283,8 +2334,15 @@ void AbstractGenerator::loadDictionary()
             
             if (needIOBuffers())
                 addInBuffers(sstDelete, subDict, elements);
+
+            if (!it->second->delMany.empty())
+                subDict->SetValueAndShowSection(tpl_STMT_MANY_CLASSNAME, it->second->delMany, tpl_STMT_MANY);
         }
         
+        // updateMany() and delMany() share the chunk size
+        if ( !(it->second->updateMany.empty() && it->second->delMany.empty() ))
+            classDict->ShowSection(tpl_STMT_BATCH);
+
         // ----- STORED PROCEDURE -----
         if ( !(it->second->stoProc.sql.empty() ))
         {
@@ -1313,4 +2371,26 @@ void AbstractGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDicti
 {
 }
 
+std::string AbstractGenerator::getUpsertSQL(const std::string& /*_table*/, const ListString& /*_columns*/, const ListString& /*_values*/,
+                                            const ListString& /*_keys*/, const ListString& /*_updates*/)
+{
+    return std::string();
+}
+
+std::string AbstractGenerator::getManySQL(const std::string& /*_table*/, const ListString& /*_columns*/, const ListString& /*_keys*/,
+                                          const std::vector<int>& /*_params*/, const ListElements& /*_input*/)
+{
+    return std::string();
+}
+
+std::string AbstractGenerator::getStreamLength(const ListElements::iterator& /*_item*/, int /*_index*/)
+{
+    return std::string();
+}
+
+std::string AbstractGenerator::getStreamRead(const ListElements::iterator& /*_item*/, int /*_index*/)
+{
+    return std::string();
+}
+
 }
@@ -56,15 +56,23 @@ enum SQLTypes
     stDouble,
     stUFloat,
     stUDouble,
+    stBool,
+    stDecimal,
     stTimeStamp,
     stTime,
     stDate,
     stText,
-    stBlob
+    stBlob,
+    stEnum
 };
 SQLTypes typeNameToSQLType(std::string _name);
+SQLTypes typeNameToSQLType(std::string _name, bool& _list);
 std::string sqlTypeToName(SQLTypes _type);
 
+// Significant digits of a DBBinderDecimal (a scaled int64_t); stDecimal
+// columns declared wider are rejected
+const int DECIMAL_MAX_PRECISION = 18;
+
 enum SQLStatementTypes
 {
     sstUnknown,
@@ -73,23 +81,41 @@ enum SQLStatementTypes
     sstUpdate,
     sstDelete,
     sstStoredProcedure,
+    sstUpsert,          // an insert that updates the row its keys already match
+};
+
+// How a select hands its rows over (MySQL: --! result)
+enum SQLResultModes
+{
+    srmStream,  // unbuffered, row by row from the connection
+    srmStore,   // whole result copied to the client on execute
+    srmCursor,  // read-only server-side cursor
 };
 
 struct SQLElement
 {
     SQLElement( const std::string& _name, SQLTypes _type, int _index = -1, int _length = 0, const std::string& _comment = "" ):
-            name( _name ), type( _type ), index( _index ), length( _length ), comment(_comment)
+            name( _name ), type( _type ), index( _index ), length( _length ), scale(0), comment(_comment), streamed(false), list(false)
     {}
     SQLElement( const std::string& _name, SQLTypes _type, int _index, const std::string& _default, const std::string& _comment = "" ):
-            name( _name ), type( _type ), index( _index ), length(0), defaultValue( _default ), comment(_comment)
+            name( _name ), type( _type ), index( _index ), length(0), scale(0), defaultValue( _default ), comment(_comment), streamed(false), list(false)
     {}
 
     std::string name;
     SQLTypes    type;
     int         index;
     int         length;
+    int         scale;      // stDecimal: digits after the point, when known when generating
+    std::vector<std::string> enumValues;    // stEnum: the labels, in declaration order
     std::string defaultValue;
     std::string comment;
+    bool        streamed;
+    bool        list;       // input only: a std::vector of values, bound as one array param
+    // Output only: the table column the value is read from, when the engine
+    // needs it to stream the value (SQLite: incremental blob I/O)
+    std::string sourceSchema;
+    std::string sourceTable;
+    std::string sourceColumn;
 };
 typedef std::vector<SQLElement> ListElements;
 
@@ -102,29 +128,51 @@ struct Location
 
 struct AbstractElements
 {
+    AbstractElements():
+        allowScan(false)
+    {}
+
     std::string         name;
     std::string         sql;
     Location            sql_location;
     ListElements        input;
     ListElements        output;
     SQLStatementTypes   type;
+    bool                allowScan;  // full table scans are expected, see --plan
 };
 
 struct SelectElements: public AbstractElements
 {
     SelectElements():
         AbstractElements(),
-        keyField(0)
+        keyField(0),
+        lazy(false),
+        resultMode(srmStream),
+        prefetchRows(1),
+        pageSize(0),
+        single(false),
+        scalar(false)
     {
         type = sstSelect;
     }
 
     std::string keyFieldName;
     int         keyField;
+    ListString  streamFieldNames;
+    bool        lazy;       // rows decode each column on first access
+    SQLResultModes  resultMode;
+    int             prefetchRows;   // rows per round trip of a srmCursor
+    int             pageSize;       // keyset pagination on the key field when > 0
+    std::string     pageKeyParam;   // input param taking the last key of a page
+    std::string     partitionLow;   // input params bounding the key range read,
+    std::string     partitionHigh;  // low <= key < high, for parallelScan()
+    bool            single;         // get(): at most one row, no iterator
+    bool            scalar;         // value(): the first column of that row
 };
 
 struct StoredProcedureElements: public SelectElements
 {
+    StoredProcedureElements(): SelectElements() { type = sstStoredProcedure; }
 };
 
 struct UpdateElements: public AbstractElements
@@ -135,6 +183,8 @@ struct UpdateElements: public AbstractElements
 struct InsertElements: public AbstractElements
 {
     InsertElements(): AbstractElements() { type = sstInsert; }
+
+    ListString  conflictKeys;   // sstUpsert: the columns identifying an existing row
 };
 
 struct DeleteElements: public AbstractElements
@@ -190,6 +240,8 @@ protected:
         InsertElements          insert;
         DeleteElements          del;
         StoredProcedureElements stoProc;
+        std::string             updateMany; // classes holding the set-based statements
+        std::string             delMany;    // behind updateMany() and delMany(), if any
     };
     typedef shared_pointer<_classParams>::type _classParamsPtr;
     typedef std::map<std::string, _classParamsPtr> classParams;
@@ -208,6 +260,9 @@ protected:
     typedef std::vector<TmplDestPair> ListTplDestPair;
     ListTplDestPair m_extraFiles;
 
+    // Sections a template asks to be shown, i.e. <section name="ARROW"/>
+    ListString      m_templSections;
+
     std::string     m_dbengine;
 
     classParams     m_classParams;
@@ -218,6 +273,13 @@ protected:
     std::string     m_outIntFile;
     std::string     m_outImplFile;
 
+    // Query plans captured with --plan, keyed by "<name> <statement>"
+    typedef std::map<std::string, std::string> mapPlans;
+    mapPlans        m_queryPlans;
+
+    void checkQueryPlan(const AbstractElements& _elements, const std::string& _plan, const ListString& _scans);
+    void writeQueryPlans();
+
 private:
     TemplateDictionary      *m_dict;
     
@@ -247,13 +309,36 @@ protected:
     virtual std::string getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) = 0;
     virtual std::string getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) = 0;
 
+    virtual std::string getStreamLength(const ListElements::iterator& _item, int _index);
+    virtual std::string getStreamRead(const ListElements::iterator& _item, int _index);
+
+    /**
+    * Rewrites "INSERT INTO _table (_columns) VALUES (_values)" into this engine's upsert:
+    * when a row with the same _keys exists, its _updates columns (the non-key ones) are set instead.
+    * @return empty if the engine can't express it
+    */
+    virtual std::string getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                     const ListString& _keys, const ListString& _updates);
+
+    /**
+    * Rewrites "UPDATE _table SET _columns = ... WHERE _keys = ..." (no _columns: "DELETE FROM _table
+    * WHERE _keys = ...") into one statement over list params: the values of _columns[i], then of
+    * _keys[i - _columns.size()], are in the list of _input[_params[i]].
+    * @return empty if the engine can't express it
+    */
+    virtual std::string getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                   const std::vector<int>& _params, const ListElements& _input);
+
     // </SUCKS>
 
     //TODO: This might be better implemented;
     static AbstractGenerator* s_generator;
 
 private:
+    void setEnumDictionary(TemplateDictionary *_dict, const SQLElement& _element);
     TemplateDictionary * setDictionaryElements(const char *_section, TemplateDictionary *_classDict, AbstractElements *_elements, SQLElement *_keyField);
+    bool setManyElements(const AbstractElements& _elements, AbstractElements& _many);
+    void showTemplSections(TemplateDictionary *_dict);
     void readParam(void* xml, const char *xmlElem, _fileTypes fileType, std::string& outFile, std::string& str, const std::string & _path);
 
 public:
@@ -281,7 +366,14 @@ public:
     }
 
     std::string getType(SQLTypes _sqlType);
+    std::string getType(const SQLElement& _element);
+    std::string getMemberType(const SQLElement& _element);
     std::string getInit(SQLTypes _sqlType);
+    std::string getColumnType(const SQLElement& _element);
+    std::string getArrowType(SQLTypes _sqlType);
+    std::string getArrowBuilder(SQLTypes _sqlType);
+    int getAlignment(SQLTypes _sqlType);
+    int getAlignment(const SQLElement& _element);
 
     void addNamespace(const std::string& _name)
     {
@@ -298,6 +390,7 @@ public:
     virtual void addSelect(SelectElements _elements);
     virtual void addUpdate(UpdateElements _elements);
     virtual void addInsert(InsertElements _elements);
+    virtual void addUpsert(InsertElements _elements);
     virtual void addDelete(DeleteElements _elements);
     virtual void addStoredProcedure(StoredProcedureElements _elements);
 };
@@ -317,6 +410,8 @@ extern const char * const tpl_FUNCTION;
 extern const char * const tpl_NAMESPACES;
 extern const char * const tpl_NAMESPACE;
 
+extern const char * const tpl_PTIME;
+
 extern const char * const tpl_CLASS;
 extern const char * const tpl_CLASSNAME;
 
@@ -336,6 +431,7 @@ extern const char * const tpl_STMT_PARAM_COUNT;
 
 extern const char * const tpl_STMT_IN_FIELDS;
 extern const char * const tpl_STMT_IN_FIELD_TYPE;
+extern const char * const tpl_STMT_IN_FIELD_MEMBER_TYPE;
 extern const char * const tpl_STMT_IN_FIELD_NAME;
 extern const char * const tpl_STMT_IN_FIELD_COMMA;
 extern const char * const tpl_STMT_IN_FIELD_INIT;
@@ -351,6 +447,40 @@ extern const char * const tpl_STMT_OUT_FIELD_GETVALUE;
 extern const char * const tpl_STMT_OUT_FIELD_ISNULL;
 extern const char * const tpl_STMT_OUT_FIELDS_BUFFERS;
 extern const char * const tpl_STMT_OUT_FIELD_COMMENT;
+extern const char * const tpl_STMT_OUT_FIELD_COLUMN_TYPE;
+extern const char * const tpl_STMT_OUT_FIELD_ARROW_TYPE;
+extern const char * const tpl_STMT_OUT_FIELD_ARROW_BUILDER;
+extern const char * const tpl_STMT_OUT_FIELD_ARROW_VALUE;
+extern const char * const tpl_STMT_OUT_FIELD_ARROW_READ;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM_TYPE;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM_BASE;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM_VALUES;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM_NAMES;
+extern const char * const tpl_STMT_OUT_FIELD_ENUM_COUNT;
+extern const char * const tpl_STMT_OUT_FIELD_NULL_BYTE;
+extern const char * const tpl_STMT_OUT_FIELD_NULL_MASK;
+extern const char * const tpl_STMT_OUT_FIELDS_PACKED;
+extern const char * const tpl_STMT_OUT_FIELD_LAZY;
+extern const char * const tpl_STMT_LAZY;
+extern const char * const tpl_STMT_PAGINATE;
+extern const char * const tpl_STMT_PAGE_SIZE;
+extern const char * const tpl_STMT_PAGE_KEY_PARAM;
+extern const char * const tpl_STMT_PARTITION;
+extern const char * const tpl_STMT_IN_FIELD_SCAN_PARAM;
+extern const char * const tpl_STMT_IN_FIELD_SCAN_ARG;
+extern const char * const tpl_PARALLEL_SCAN;
+extern const char * const tpl_STMT_FETCH_ONE;
+extern const char * const tpl_STMT_SINGLE;
+extern const char * const tpl_STMT_SCALAR;
+extern const char * const tpl_STMT_SCALAR_TYPE;
+extern const char * const tpl_STMT_SCALAR_NAME;
+extern const char * const tpl_STMT_INSERT_METHOD;
+extern const char * const tpl_STMT_BATCH;
+extern const char * const tpl_STMT_MANY;
+extern const char * const tpl_STMT_MANY_CLASSNAME;
+extern const char * const tpl_STMT_IN_FIELD_LIST_TYPE;
+extern const char * const tpl_STMT_OUT_NULL_BYTES;
 extern const char * const tpl_STMT_OUT_KEY_FIELD_NAME;
 extern const char * const tpl_STMT_OUT_KEY_FIELD_TYPE;
 
@@ -377,6 +507,9 @@ extern const char * const tpl_DBENGINE_DISCONNECT;
 extern const char * const tpl_DBENGINE_RESET_SELECT;
 extern const char * const tpl_DBENGINE_EXECUTE_SELECT;
 extern const char * const tpl_DBENGINE_FETCH_SELECT;
+extern const char * const tpl_DBENGINE_ROW_COUNT_SELECT;
+
+extern const char * const tpl_DBENGINE_BATCH_SIZE;
 
 extern const char * const tpl_DBENGINE_CREATE_SPROC;
 extern const char * const tpl_DBENGINE_PREPARE_SPROC;
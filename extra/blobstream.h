@@ -23,6 +23,7 @@
 #include <vector>
 #include <istream>
 #include <cstring>
+#include <functional>
 
 namespace DBBinder
 {
@@ -127,6 +128,77 @@ public:
     }
 };
 
+/**
+ * @class ChunkStream
+ * std::istream over a streamed field.
+ *
+ * Fields marked with "--! stream <field>" are not copied into the
+ * rows; the statement gets a read<field>(buffer, length, offset)
+ * method instead.  This class pulls the value through that method
+ * one chunk at a time, so only a single chunk is held in memory.
+ *
+ * Example:
+ *
+ *    DBBinder::ChunkStream stream([&sel](char *b, size_t l, size_t o) { return sel.readData(b, l, o); });
+ *    pb->parseFromIstream(stream.istream());
+ */
+class ChunkStream
+{
+public:
+    typedef std::function<size_t (char*, size_t, size_t)> reader_t;
+
+private:
+    typedef char char_t;
+    typedef std::char_traits<char_t> traits_t;
+
+    class ChunkWrapper : public std::basic_streambuf<char_t, traits_t> {
+    private:
+        reader_t            _reader;
+        std::vector<char_t> _chunk;
+        size_t              _offset;
+    public:
+        ChunkWrapper(reader_t reader, size_t chunkSize):
+            _reader(reader),
+            _chunk(chunkSize),
+            _offset(0)
+        {
+            setg(_chunk.data(), _chunk.data(), _chunk.data());
+        }
+    protected:
+        virtual int_type underflow() override
+        {
+            if (gptr() < egptr())
+                return traits_t::to_int_type(*gptr());
+
+            size_t count = _reader(_chunk.data(), _chunk.size(), _offset);
+
+            if (count == 0)
+                return traits_t::eof();
+
+            _offset += count;
+            setg(_chunk.data(), _chunk.data(), _chunk.data() + count);
+
+            return traits_t::to_int_type(*gptr());
+        }
+    };
+
+    ChunkWrapper _wrapper;
+
+    std::istream _istream;
+
+public:
+    ChunkStream(reader_t reader, size_t chunkSize = 64 * 1024):
+        _wrapper(reader, chunkSize),
+        _istream(&_wrapper)
+    {
+    }
+
+    std::istream* istream()
+    {
+        return &_istream;
+    }
+};
+
 }
 
 #endif // DBBINDERBLOBSTREAM_H
@@ -62,8 +62,19 @@ inline bool checkFBError( const ISC_STATUS *_status )
     return false;
 }
 
-SQLTypes fbtypeToSQLType(const int _fbtype)
+SQLTypes fbtypeToSQLType(const int _fbtype, const int _fbscale = 0)
 {
+        switch( _fbtype & ~1 )
+        {
+            case SQL_SHORT:
+            case SQL_LONG:
+            case SQL_INT64:
+                // NUMERIC/DECIMAL are integers with a negative scale
+                if ( _fbscale < 0 )
+                    return stDecimal;
+                break;
+        }
+
         switch( _fbtype & ~1 )
         {
             case SQL_TEXT:
@@ -90,6 +101,10 @@ SQLTypes fbtypeToSQLType(const int _fbtype)
                 return stDate;
             case SQL_INT64:
                 return stInt64;
+#ifdef SQL_BOOLEAN
+            case SQL_BOOLEAN:
+                return stBool;
+#endif
             default:
                 return stText;
         }
@@ -108,6 +123,7 @@ void getFirebirdTypes( SQLTypes _type, std::string &_lang, std::string &_fb )
             break;
         case stInt64:
         case stUInt64:
+        case stDecimal:
             _lang = "ISC_INT64";
             _fb = "SQL_INT64";
             break;
@@ -123,15 +139,20 @@ void getFirebirdTypes( SQLTypes _type, std::string &_lang, std::string &_fb )
             break;
         case stTimeStamp:
             _lang = "ISC_TIMESTAMP";
-            _fb = "SQL_LONG";
+            _fb = "SQL_TIMESTAMP";
             break;
         case stTime:
             _lang = "ISC_TIME";
-            _fb = "SQL_LONG";
+            _fb = "SQL_TYPE_TIME";
             break;
         case stDate:
             _lang = "ISC_DATE";
-            _fb = "SQL_LONG";
+            _fb = "SQL_TYPE_DATE";
+            break;
+        case stBool:
+            // Firebird 3
+            _lang = "FB_BOOLEAN";
+            _fb = "SQL_BOOLEAN";
             break;
         case stText:
             _lang = "ISC_SCHAR";
@@ -141,6 +162,24 @@ void getFirebirdTypes( SQLTypes _type, std::string &_lang, std::string &_fb )
 }
 
 
+// Size of the C type getFirebirdTypes picks, for laying out the output arena
+int firebirdTypeSize( SQLTypes _type )
+{
+    switch ( _type )
+    {
+        case stInt64:
+        case stUInt64:
+        case stDecimal:
+        case stDouble:
+        case stUDouble:
+        case stTimeStamp:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+
 FirebirdGenerator::FirebirdGenerator()
 : AbstractGenerator(), m_conn(0)
 {
@@ -200,88 +239,115 @@ bool FirebirdGenerator::checkConnection()
     return m_connected;
 }
 
-std::string FirebirdGenerator::getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index)
+std::string FirebirdGenerator::getBind(SQLStatementTypes /*_type*/, const ListElements::iterator& _item, int _index)
 {
-    // TODO Abstract this
-    std::string var("inBuffer->sqlvar[");
-
-    {
-        char buff[7] = {0,0,0,0,0,0,0};
-        snprintf(buff, 6, "%d", _index);
-        var += buff;
-    }
+    if ( _item->list )
+        FATAL("'" << _item->name << "': list params are not supported by the Firebird generator");
 
-    var += "]";
+    // The XSQLDA itself is laid out by addInBuffers; this only points each
+    // sqlvar at the caller's value, so nothing is copied or allocated.
+    std::stringstream var;
+    var << "inBuffer->sqlvar[" << _index << "]";
 
     std::stringstream str;
 
-    if ( _index == 0 )
-    {
-        str << "ISC_SHORT __ZERO = 0;\n\n";
-
-        std::string type;
-        switch ( _type )
-        {
-            case sstSelect:
-                type = "select";
-                break;
-            case sstInsert:
-                type = "insert";
-                break;
-            case sstUpdate:
-                type = "update";
-                break;
-            case sstDelete:
-                type = "delete";
-                break;
-            default:
-                FATAL(__FILE__  << ':' << __LINE__ << ": Invalid statement type.");
-        };
-
-        str << "XSQLDA inBuffer[ XSQLDA_LENGTH( s_" << type << "ParamCount ) ];\n";
-        str << "memset(inBuffer, 0, XSQLDA_LENGTH( s_" << type << "ParamCount ));\n";
-        str << "inBuffer->version = SQLDA_VERSION1;\n";
-        str << "inBuffer->sqln = s_" << type << "ParamCount;\n";
-        str << "isc_dsql_describe_bind( err, &m_" << type << "Stmt, s_" << type << "ParamCount, inBuffer );\n\n";
-    }
+    std::string type, lang;
 
-    std::string type, size;
+    getFirebirdTypes(_item->type, lang, type);
 
-    getFirebirdTypes(_item->type, size, type);
+    str << var.str() << ".sqlind = &inNull[" << _index << "];\n";
 
-    str << var << ".sqltype = " << type << " + 1;\n";
-
-    if ( _item->type != stText )
+    if ( _item->type == stDecimal )
+    {
+        // Sent with the value's own scale, the server rescales it
+        str << "inNull[" << _index << "] = 0;\n";
+        str << "inCopy[" << _index << "] = _" << _item->name << ".value();\n";
+        str << var.str() << ".sqltype = SQL_INT64 + 1;\n";
+        str << var.str() << ".sqllen = sizeof(ISC_INT64);\n";
+        str << var.str() << ".sqlscale = -_" << _item->name << ".scale();\n";
+        str << var.str() << ".sqldata = reinterpret_cast<ISC_SCHAR*>(&inCopy[" << _index << "]);\n";
+    }
+    else if ( _item->type == stTimeStamp || _item->type == stTime || _item->type == stDate )
     {
-        str << var << ".sqldata = reinterpret_cast<ISC_SCHAR*>(&(_" << _item->name << "));\n";
+        // Converted from the caller's representation into the ISC one
+        str << "inNull[" << _index << "] = dbbinderTimeIsNull(_" << _item->name << ") ? -1 : 0;\n";
+        str << "{\n"
+            << "int64_t micros = dbbinderToMicros(_" << _item->name << ");\n";
+        if ( _item->type == stTimeStamp )
+            str << "reinterpret_cast<ISC_TIMESTAMP*>(&inCopy[" << _index << "])->timestamp_date = fbMicrosToDate(micros);\n"
+                << "reinterpret_cast<ISC_TIMESTAMP*>(&inCopy[" << _index << "])->timestamp_time = fbMicrosToTime(micros);\n";
+        else if ( _item->type == stTime )
+            str << "*reinterpret_cast<ISC_TIME*>(&inCopy[" << _index << "]) = fbMicrosToTime(micros);\n";
+        else
+            str << "*reinterpret_cast<ISC_DATE*>(&inCopy[" << _index << "]) = fbMicrosToDate(micros);\n";
+        str << "}\n";
+        str << var.str() << ".sqltype = " << type << " + 1;\n";
+        str << var.str() << ".sqllen = sizeof(" << lang << ");\n";
+        str << var.str() << ".sqldata = reinterpret_cast<ISC_SCHAR*>(&inCopy[" << _index << "]);\n";
+    }
+    else if ( _item->type != stText )
+    {
+        str << "inNull[" << _index << "] = 0;\n";
+        str << var.str() << ".sqltype = " << type << " + 1;\n";
+        str << var.str() << ".sqllen = sizeof(" << lang << ");\n";
+        str << var.str() << ".sqldata = reinterpret_cast<ISC_SCHAR*>(&(_" << _item->name << "));\n";
     }
     else
     {
-        str << var << ".sqldata = reinterpret_cast<ISC_SCHAR*>(malloc(strlen(_" << _item->name << ") + 1 + sizeof(short)));\n";
-        str << "*(reinterpret_cast<short*>( " << var << ".sqldata )) = strlen(_" << _item->name << ");\n";
-        str << "strcpy(" << var << ".sqldata + sizeof(short), _" << _item->name << ");\n";
+        str << "inNull[" << _index << "] = (_" << _item->name << ") ? 0 : -1;\n";
+        str << var.str() << ".sqltype = SQL_TEXT + 1;\n";
+        str << var.str() << ".sqllen = (_" << _item->name << ") ? strlen(_" << _item->name << ") : 0;\n";
+        str << var.str() << ".sqldata = const_cast<ISC_SCHAR*>(reinterpret_cast<const ISC_SCHAR*>(_" << _item->name << "));\n";
     }
 
-    str << var << ".sqlind = &(__ZERO);\n";
-
     return str.str();
 }
 
-std::string FirebirdGenerator::getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index)
+std::string FirebirdGenerator::getReadValue(SQLStatementTypes /*_type*/, const ListElements::iterator& _item, int _index)
 {
     std::stringstream str;
 
-    str << "if ( _parent->m_selOutBuffer->sqlvar[" << _index << "].sqlind != 0 )\n\t";
+    str << "if ( *(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqlind) != -1 )\n{\n";
 
     if ( _item->type == stText )
-        str << "m_" << _item->name << " = _parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata + sizeof(short);";
+    {
+        // SQL_VARYING isn't terminated; its slot has a spare byte for the '\0'
+        str << "ISC_SCHAR *data = _parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata;\n"
+            << "data[sizeof(short) + *reinterpret_cast<short*>(data)] = '\\0';\n"
+            << "m_" << _item->name << " = data + sizeof(short);\n";
+    }
+    else if ( _item->type == stDecimal )
+    {
+        str << "m_" << _item->name << " = DBBinderDecimal(*(reinterpret_cast<ISC_INT64*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata)), "
+            << "-_parent->m_selOutBuffer->sqlvar[" << _index << "].sqlscale);\n";
+    }
+    else if ( _item->type == stTimeStamp )
+    {
+        str << "ISC_TIMESTAMP *data = reinterpret_cast<ISC_TIMESTAMP*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata);\n"
+            << "dbbinderFromMicros(fbTimeToMicros(data->timestamp_date, data->timestamp_time), m_" << _item->name << ");\n";
+    }
+    else if ( _item->type == stTime )
+    {
+        str << "dbbinderFromMicros(fbTimeToMicros(FB_EPOCH_DAYS, *(reinterpret_cast<ISC_TIME*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata))), m_" << _item->name << ");\n";
+    }
+    else if ( _item->type == stDate )
+    {
+        str << "dbbinderFromMicros(fbTimeToMicros(*(reinterpret_cast<ISC_DATE*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata)), 0), m_" << _item->name << ");\n";
+    }
     else
-        str << "m_" << _item->name << " = *(reinterpret_cast<ISC_LONG*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata));";
+    {
+        std::string lang, fb;
+        getFirebirdTypes(_item->type, lang, fb);
+
+        str << "m_" << _item->name << " = *(reinterpret_cast<" << lang << "*>(_parent->m_selOutBuffer->sqlvar[" << _index << "].sqldata));\n";
+    }
+
+    str << "}";
 
     return str.str();
 }
 
-std::string FirebirdGenerator::getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index)
+std::string FirebirdGenerator::getIsNull(SQLStatementTypes /*_type*/, const ListElements::iterator& /*_item*/, int _index)
 {
     // TODO Abstract this
     std::string result("( *(_parent->m_selOutBuffer->sqlvar[");
@@ -297,6 +363,15 @@ std::string FirebirdGenerator::getIsNull(SQLStatementTypes _type, const ListElem
     return result;
 }
 
+std::string FirebirdGenerator::getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                            const ListString& _keys, const ListString& /*_updates*/)
+{
+    // UPDATE OR INSERT is from Firebird 2.1; it also sets the keys, to the values they matched
+    return "UPDATE OR INSERT INTO " + _table + " (" + stringJoin( _columns, ", " ) + ")\n"
+           "VALUES (" + stringJoin( _values, ", " ) + ")\n"
+           "MATCHING (" + stringJoin( _keys, ", " ) + ")";
+}
+
 void FirebirdGenerator::addSelect(SelectElements _elements)
 {
     checkConnection();
@@ -353,9 +428,13 @@ void FirebirdGenerator::addSelect(SelectElements _elements)
         {
             comment.append( p->sqlname, p->sqlname_length );
         }
-        _elements.output.push_back( SQLElement( p->aliasname, fbtypeToSQLType( p->sqltype ), i, p->sqllen, comment ));
+        _elements.output.push_back( SQLElement( p->aliasname, fbtypeToSQLType( p->sqltype, p->sqlscale ), i, p->sqllen, comment ));
+        _elements.output.back().scale = -p->sqlscale;
     }
 
+    if ( !optPlanCheck.empty() )
+        explain( _elements, &stmt );
+
     //Free, deallocate and rollback everything
 
     free(buffOutput);
@@ -369,105 +448,177 @@ void FirebirdGenerator::addSelect(SelectElements _elements)
     AbstractGenerator::addSelect(_elements);
 }
 
+void FirebirdGenerator::explain(const AbstractElements& _elements, isc_stmt_handle *_stmt)
+{
+    ISC_STATUS err[32];
+    const char item = isc_info_sql_get_plan;
+    std::vector<char> buff( 1024 );
+
+    // Ask again with a bigger buffer while the plan doesn't fit
+    for(;;)
+    {
+        isc_dsql_sql_info( err, _stmt, 1, &item, buff.size(), &buff[0] );
+        checkFBError( err );
+
+        if ( buff[0] != isc_info_truncated || buff.size() > 16384 )
+            break;
+
+        buff.resize( buff.size() * 2 );
+    }
+
+    if ( buff[0] != isc_info_sql_get_plan )
+        FATAL( _elements.sql_location.file << ": unable to read the query plan" );
+
+    // "PLAN (T NATURAL)", one line per query/subquery; NATURAL is a full table scan
+    std::stringstream text( std::string( &buff[3], isc_vax_integer( &buff[1], 2 )));
+    std::string plan, line;
+    ListString scans;
+
+    while ( std::getline( text, line ))
+    {
+        if ( line.empty() )
+            continue;
+
+        plan += line + '\n';
+
+        if ( line.find( " NATURAL" ) != std::string::npos )
+            scans.push_back( line );
+    }
+
+    checkQueryPlan( _elements, plan, scans );
+}
+
 bool FirebirdGenerator::needIOBuffers() const
 {
     return true;
 }
 
-void FirebirdGenerator::addInBuffers(SQLStatementTypes _type, const AbstractElements* _elements)
+void FirebirdGenerator::addInBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements* _elements)
 {
+    TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_IN_FIELDS_BUFFERS);
+
     if ( _elements->input.empty() )
     {
-        TemplateDictionary *subDict;
-
+        buffDict->SetValue(tpl_BUFFER_ALLOC, "XSQLDA *inBuffer = 0;" );
+    }
+    else
+    {
+        std::string prefix;
         switch ( _type )
         {
-            case sstSelect:
-                subDict = m_dict->AddSectionDictionary(tpl_SEL_IN_FIELDS_BUFFERS);
-                break;
-            case sstInsert:
-                subDict = m_dict->AddSectionDictionary(tpl_INS_IN_FIELDS_BUFFERS);
-                break;
-            case sstUpdate:
-                subDict = m_dict->AddSectionDictionary(tpl_UPD_IN_FIELDS_BUFFERS);
-                break;
-            case sstDelete:
-                subDict = m_dict->AddSectionDictionary(tpl_DEL_IN_FIELDS_BUFFERS);
-                break;
+            case sstSelect: prefix = "m_select"; break;
+            case sstInsert: prefix = "m_insert"; break;
+            case sstUpdate: prefix = "m_update"; break;
+            case sstDelete: prefix = "m_delete"; break;
             default:
                 FATAL(__FILE__  << ':' << __LINE__ << ": Invalid statement type.");
         };
 
-        subDict->SetValue(tpl_BUFFER_ALLOC, "XSQLDA* inBuffer = 0;" );
-    }
-    else
-    {
-        /*
-            Nothing to see here.. please move on to:
-            FirebirdGenerator::getBind
-                -> if ( _index == 0 )
-        */
+        int count = _elements->input.size();
+        std::stringstream decl, init, alloc;
+
+        bool hasCopy = false;
+        for(ListElements::const_iterator it = _elements->input.begin(); it != _elements->input.end(); ++it)
+            hasCopy |= it->type == stDecimal || it->type == stTimeStamp || it->type == stTime || it->type == stDate;
+
+        // Only the descriptor lives here: getBind points sqldata at the parameters
+        // (decimals and dates excepted, they are converted into InCopy)
+        decl << "ISC_INT64 " << prefix << "InArena[DBBINDER_FB_WORDS( XSQLDA_LENGTH( " << count << " ) )];\n"
+             << "ISC_SHORT " << prefix << "InNull[" << count << "];\n";
+        if ( hasCopy )
+            decl << "ISC_INT64 " << prefix << "InCopy[" << count << "];\n";
+
+        init << "memset(" << prefix << "InArena, 0, sizeof(" << prefix << "InArena));\n"
+             << "reinterpret_cast<XSQLDA*>(" << prefix << "InArena)->version = SQLDA_VERSION1;\n"
+             << "reinterpret_cast<XSQLDA*>(" << prefix << "InArena)->sqln = " << count << ";\n"
+             << "reinterpret_cast<XSQLDA*>(" << prefix << "InArena)->sqld = " << count << ";\n\n";
+
+        alloc << "XSQLDA *inBuffer = reinterpret_cast<XSQLDA*>(" << prefix << "InArena);\n"
+              << "ISC_SHORT *inNull = " << prefix << "InNull;\n";
+        if ( hasCopy )
+            alloc << "ISC_INT64 *inCopy = " << prefix << "InCopy;\n";
+        alloc << "\n";
+
+        buffDict->SetValue(tpl_BUFFER_DECLARE, decl.str() );
+        buffDict->SetValue(tpl_BUFFER_INITIALIZE, init.str() );
+        buffDict->SetValue(tpl_BUFFER_ALLOC, alloc.str() );
     }
 }
 
-void FirebirdGenerator::addOutBuffers(SQLStatementTypes _type, const AbstractIOElements* _elements)
+void FirebirdGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictionary *_subDict, const AbstractElements* _elements)
 {
-    TemplateDictionary *subDict;
-    subDict = m_dict->AddSectionDictionary(tpl_SEL_OUT_FIELDS_BUFFERS);
-    subDict->SetValue(tpl_BUFFER_DECLARE, "XSQLDA *m_selOutBuffer;" );
-    subDict->SetValue(tpl_BUFFER_INITIALIZE,
-                                            "m_selOutBuffer = (XSQLDA *)malloc( XSQLDA_LENGTH( s_selectFieldCount ) );\n"
-                                            "memset(m_selOutBuffer, 0, XSQLDA_LENGTH( s_selectFieldCount ));\n"
-                                            "m_selOutBuffer->version = SQLDA_VERSION1;\n"
-                                            "m_selOutBuffer->sqln = s_selectFieldCount;\n\n"
-                                            );
+    /*
+        The output XSQLDA, the data slots and the null indicators share one
+        arena: the descriptor first, then each slot at a fixed offset worked
+        out here, then the indicators.  Text slots are SQL_VARYING: a short
+        length, the characters and one spare byte for the terminator.
+    */
+    int count = _elements->output.size();
+    int offset = 0;
+    std::vector<int> dataOffsets;
 
-    std::stringstream bufAlloc, bufFree;
+    std::string fb, lang;
 
-    bufAlloc << "{\n";
+    for(ListElements::const_iterator it = _elements->output.begin(); it != _elements->output.end(); ++it)
+    {
+        int size = (it->type == stText) ? int(sizeof(short)) + it->length + 1 : firebirdTypeSize( it->type );
+        int align = (it->type == stText) ? int(sizeof(short)) : size;
 
+        offset = (offset + align - 1) / align * align;
+        dataOffsets.push_back(offset);
+        offset += size;
+    }
 
-    bufFree << "if (m_selOutBuffer)\n{\n";
+    offset = (offset + sizeof(short) - 1) / sizeof(short) * sizeof(short);
+    int indOffset = offset;
+    offset += count * sizeof(short);
 
-    std::string fb, lang;
+    int dataWords = (offset + 7) / 8;
 
-    char idx[9];
-    idx[8] = 0;
-    for(ListElements::const_iterator it = _elements->output.begin(); it != _elements->output.end(); ++it)
+    std::stringstream decl, init, alloc;
+
+    decl << "ISC_INT64 m_selOutArena[DBBINDER_FB_WORDS( XSQLDA_LENGTH( " << count << " ) ) + " << dataWords << "];\n"
+         << "XSQLDA    *m_selOutBuffer;\n";
+
+    init << "memset(m_selOutArena, 0, sizeof(m_selOutArena));\n"
+         << "m_selOutBuffer = reinterpret_cast<XSQLDA*>(m_selOutArena);\n"
+         << "m_selOutBuffer->version = SQLDA_VERSION1;\n"
+         << "m_selOutBuffer->sqln = " << count << ";\n\n";
+
+    alloc << "{\n"
+          << "ISC_SCHAR *data = reinterpret_cast<ISC_SCHAR*>(&m_selOutArena[DBBINDER_FB_WORDS( XSQLDA_LENGTH( " << count << " ) )]);\n\n";
+
+    int index = 0;
+    for(ListElements::const_iterator it = _elements->output.begin(); it != _elements->output.end(); ++it, ++index)
     {
-        snprintf(idx, 8, "%d", it->index);
-        getFirebirdTypes( it->type, lang, fb );
+        std::stringstream var;
+        var << "m_selOutBuffer->sqlvar[" << it->index << "]";
 
-        bufAlloc << "m_selOutBuffer->sqlvar[" << idx << "].sqldata = ";
-        bufAlloc << "reinterpret_cast<ISC_SCHAR*>(malloc( ";
+        getFirebirdTypes( it->type, lang, fb );
 
         if ( it->type == stText )
         {
-            bufAlloc << "m_selOutBuffer->sqlvar[" << idx << "].sqllen + 1 ));\n";
-            bufAlloc << "m_selOutBuffer->sqlvar[" << idx << "].sqltype = SQL_VARYING + 1;";
+            alloc << var.str() << ".sqltype = SQL_VARYING + 1;\n";
+            alloc << var.str() << ".sqllen = " << it->length << ";\n";
         }
         else
         {
-            bufAlloc << "sizeof(" << lang << ") ));\n";
-            bufAlloc << "m_selOutBuffer->sqlvar[" << idx << "].sqltype = " << fb << " + 1;";
+            alloc << var.str() << ".sqltype = " << fb << " + 1;\n";
+            alloc << var.str() << ".sqllen = sizeof(" << lang << ");\n";
+            if ( it->type == stDecimal )
+                alloc << var.str() << ".sqlscale = " << -it->scale << ";\n";
         }
 
-        bufAlloc << "m_selOutBuffer->sqlvar[" << idx << "].sqlind = reinterpret_cast<ISC_SHORT*>(malloc(sizeof(ISC_SHORT)));\n";
-
-        bufFree << "free( m_selOutBuffer->sqlvar[" << idx << "].sqldata );";
-        bufFree << "free( m_selOutBuffer->sqlvar[" << idx << "].sqlind );";
+        alloc << var.str() << ".sqldata = data + " << dataOffsets[index] << ";\n";
+        alloc << var.str() << ".sqlind = reinterpret_cast<ISC_SHORT*>(data + " << indOffset + index * sizeof(short) << ");\n";
     }
 
-    bufAlloc << "}\n";
-
-    bufFree << "free(m_selOutBuffer);\n";
-    bufFree << "m_selOutBuffer = NULL;\n}";
+    alloc << "}\n";
 
-    subDict->SetValue(tpl_BUFFER_ALLOC, bufAlloc.str() );
-
-
-    subDict->SetValue(tpl_BUFFER_FREE, bufFree.str() );
+    TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS_BUFFERS);
+    buffDict->SetValue(tpl_BUFFER_DECLARE, decl.str() );
+    buffDict->SetValue(tpl_BUFFER_INITIALIZE, init.str() );
+    buffDict->SetValue(tpl_BUFFER_ALLOC, alloc.str() );
 }
 
 }
-
@@ -39,16 +39,20 @@ class FirebirdGenerator : public AbstractGenerator
     private:
         isc_db_handle	m_conn;
 
+        void explain(const AbstractElements& _elements, isc_stmt_handle *_stmt);
+
     protected:
         virtual bool checkConnection();
         virtual std::string getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index);
         virtual std::string getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index);
         virtual std::string getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index);
+        virtual std::string getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                         const ListString& _keys, const ListString& _updates);
 
         virtual bool   needIOBuffers() const;
 
-        virtual void addInBuffers(SQLStatementTypes _type, const AbstractElements* _elements);
-        virtual void addOutBuffers(SQLStatementTypes _type, const AbstractIOElements* _elements);
+        virtual void addInBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements* _elements);
+        virtual void addOutBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements* _elements);
 
 };
 
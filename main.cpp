@@ -43,6 +43,7 @@ bool            optListDepends = false;
 ListString      optDepends;
 bool            optExtras = false;
 ListString      optIncludeFiles;
+std::string     optPlanCheck;
 
 static const char* defaultTemplateDirs[] =
 {
@@ -142,6 +143,7 @@ int main(int argc, char *argv[])
         ("sql-param", po::value<ListString>(), "PARAM,TYPE[,DEFAULT] parameters for the SQL command\n"
             "\texample: --param name,string,'no name' --param age,int"
         )
+        ("plan", po::value<std::string>(), "warn|error save every statement's query plan to OUTPUT.plan and report full table scans")
         ("version,V", "program version")
         ("vmajor", "major program version")
         ("vminor", "minor program version");
@@ -246,6 +248,14 @@ int main(int argc, char *argv[])
     optListDepends = vm.count("depends");
     optExtras = vm.count("extras");
 
+    if (vm.count("plan"))
+    {
+        optPlanCheck = vm["plan"].as<std::string>();
+
+        if ( optPlanCheck != "warn" && optPlanCheck != "error" )
+            FATAL_EXIT("--plan must be 'warn' or 'error'");
+    }
+
     if (vm.count("include"))
         optIncludeFiles = vm["include"].as<ListString>();
 
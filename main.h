@@ -70,6 +70,7 @@ extern bool         optListDepends;
 extern ListString   optDepends;
 extern bool         optExtras;
 extern ListString   optIncludeFiles;
+extern std::string  optPlanCheck;
 
 // Utility funcs and defines
 inline std::string stringToLower(const std::string& _string)
@@ -133,6 +134,20 @@ inline ListString stringTok(const std::string &_string, const char _sep)
 
 ListString stringTok(const char* _str);
 
+inline std::string stringJoin(const ListString &_list, const char *_sep)
+{
+    std::string result;
+
+    for (ListString::const_iterator it = _list.begin(); it != _list.end(); ++it)
+    {
+        if ( it != _list.begin() )
+            result += _sep;
+        result += *it;
+    }
+
+    return result;
+}
+
 inline std::string getFilenameRelativeTo(const std::string& _relFileName, const std::string& _fileName)
 {
     std::string result;
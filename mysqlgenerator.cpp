@@ -98,6 +98,20 @@ bool MySQLGenerator::checkConnection()
     return m_connected;
 }
 
+static std::string stmtPrefix(SQLStatementTypes _type)
+{
+    switch ( _type )
+    {
+        case sstSelect: return "m_select";
+        case sstInsert: return "m_insert";
+        case sstUpdate: return "m_update";
+        case sstDelete: return "m_delete";
+        case sstStoredProcedure: return "m_sproc";
+        default:
+            FATAL(__FILE__  << ':' << __LINE__ << ": Invalid statement type.");
+    };
+}
+
 std::string MySQLGenerator::getBind(SQLStatementTypes /*_type*/, const ListElements::iterator& /*_item*/, int /*_index*/)
 {
     return "";
@@ -105,16 +119,45 @@ std::string MySQLGenerator::getBind(SQLStatementTypes /*_type*/, const ListEleme
 
 std::string MySQLGenerator::getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index)
 {
-    UNUSED(_type);
+    // Selects and stored procedures fetch into the same selOutBuffer
+    std::string stmt = "_parent->" + stmtPrefix(_type) + "Stmt";
+
     switch(_item->type)
     {
         case stTimeStamp:
-            return std::string("m_") + _item->name + " = dbbinderConvertTime(_parent->m_buff" + _item->name + ");";
+        case stTime:
+        case stDate:
+            return "dbbinderFromMicros(dbbinderMyTimeToMicros(_parent->m_buff" + _item->name + "), m_" + _item->name + ");";
+        case stDecimal:
+            // The length is the whole value's even when the buffer truncated it
+            return "if (!_parent->m_" + _item->name + "IsNull && _parent->m_" + _item->name + "Length >= DBBinderDecimal::STRING_SIZE)\n"
+                   "    DBBINDER_THROW(false, 0, \"22003\", \"Decimal overflow: " + _item->name + " has \" << _parent->m_" + _item->name + "Length << \" chars\");\n"
+                   "m_" + _item->name + " = DBBinderDecimal::parse(_parent->m_buff" + _item->name +
+                   ", _parent->m_" + _item->name + "IsNull ? 0 : _parent->m_" + _item->name + "Length);";
+        case stEnum:
+            return "_parent->m_buff" + _item->name + "[_parent->m_" + _item->name + "IsNull ? 0 : _parent->m_" + _item->name + "Length] = 0;\n"
+                   "fromString(_parent->m_buff" + _item->name + ", m_" + _item->name + ");";
         case stText:
         {
+            // Values longer than the inline buffer are truncated by mysql_stmt_fetch
+            // and read again, whole, into the column's overflow vector
             std::stringstream str;
-            str << "m_" << _item->name << " = _parent->m_buff" << _item->name + ";\n";
-            str << "_parent->m_buff" << _item->name + "[" << _item->length << "] = 0;";
+            str << "if (_parent->m_" << _item->name << "Error && !_parent->m_" << _item->name << "IsNull)\n{\n";
+            str << "MYSQL_BIND bind;\n"
+                << "memset(&bind, 0, sizeof(bind));\n"
+                << "_parent->m_" << _item->name << "Overflow.resize(_parent->m_" << _item->name << "Length + 1);\n"
+                << "bind.buffer_type = MYSQL_TYPE_STRING;\n"
+                << "bind.buffer = &_parent->m_" << _item->name << "Overflow[0];\n"
+                << "bind.buffer_length = _parent->m_" << _item->name << "Length;\n"
+                << "mysqlCheckStmtErr(" << stmt << ", mysql_stmt_fetch_column(" << stmt << ", &bind, " << _index << ", 0));\n\n"
+                << "_parent->m_" << _item->name << "Overflow[_parent->m_" << _item->name << "Length] = 0;\n"
+                << "m_" << _item->name << " = &_parent->m_" << _item->name << "Overflow[0];\n";
+            str << "}\nelse\n{\n";
+            // The inline buffer, or a slice of m_selectStored when the result is stored
+            str << "char *buff = static_cast<char*>(_parent->selOutBuffer[" << _index << "].buffer);\n"
+                << "buff[_parent->m_" << _item->name << "IsNull ? 0 : _parent->m_" << _item->name << "Length] = 0;\n"
+                << "m_" << _item->name << " = buff;\n";
+            str << "}";
             return str.str();
         }
         case stBlob:
@@ -129,7 +172,7 @@ std::string MySQLGenerator::getReadValue(SQLStatementTypes _type, const ListElem
             str << "_parent->selOutBuffer[" << _index <<"].buffer = m_" << _item->name << "->data();\n\n";
 
             str << "if(_parent->m_" << _item->name + "Length)\n";
-            str << "mysqlCheckStmtErr(_parent->m_selectStmt, mysql_stmt_fetch_column(_parent->m_selectStmt, &(_parent->selOutBuffer[" << _index << "]), " << _index << ", 0));\n\n";
+            str << "mysqlCheckStmtErr(" << stmt << ", mysql_stmt_fetch_column(" << stmt << ", &(_parent->selOutBuffer[" << _index << "]), " << _index << ", 0));\n\n";
 
             str << "_parent->selOutBuffer[" << _index << "].buffer_length = 0;\n";
             str << "_parent->selOutBuffer[" << _index <<"].buffer = NULL;\n";
@@ -144,12 +187,119 @@ std::string MySQLGenerator::getReadValue(SQLStatementTypes _type, const ListElem
 
 std::string MySQLGenerator::getIsNull(SQLStatementTypes /*_type*/, const ListElements::iterator& _item, int /*_index*/)
 {
-    return "_parent->m_" + _item->name + "IsNull;";
+    return "_parent->m_" + _item->name + "IsNull";
+}
+
+std::string MySQLGenerator::getStreamLength(const ListElements::iterator& _item, int /*_index*/)
+{
+    return "return m_" + _item->name + "Length;";
+}
+
+std::string MySQLGenerator::getStreamRead(const ListElements::iterator& _item, int _index)
+{
+    std::stringstream str;
+
+    str << "if (_offset >= m_" << _item->name << "Length)\n"
+        << "    return 0;\n\n"
+        << "MYSQL_BIND bind;\n"
+        << "long unsigned length = 0;\n"
+        << "memset(&bind, 0, sizeof(bind));\n"
+        << "bind.buffer_type = MYSQL_TYPE_BLOB;\n"
+        << "bind.buffer = _buffer;\n"
+        << "bind.buffer_length = _length;\n"
+        << "bind.length = &length;\n"
+        << "mysqlCheckStmtErr(m_selectStmt, mysql_stmt_fetch_column(m_selectStmt, &bind, " << _index << ", _offset));\n\n"
+        << "return std::min<size_t>(_length, m_" << _item->name << "Length - _offset);";
+
+    return str.str();
+}
+
+std::string MySQLGenerator::getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                         const ListString& _keys, const ListString& _updates)
+{
+    // MySQL matches on any unique key of the table, _keys only document which one is meant
+    std::stringstream str;
+
+    str << "INSERT INTO " << _table << " (" << stringJoin(_columns, ", ") << ")\n"
+        << "VALUES (" << stringJoin(_values, ", ") << ")\n"
+        << "ON DUPLICATE KEY UPDATE ";
+
+    if (_updates.empty())
+        str << _keys.front() << " = " << _keys.front();
+    else
+    {
+        for (ListString::const_iterator it = _updates.begin(); it != _updates.end(); ++it)
+            str << (it == _updates.begin() ? "" : ", ") << *it << " = VALUES(" << *it << ")";
+    }
+
+    return str.str();
+}
+
+std::string MySQLGenerator::getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                       const std::vector<int>& _params, const ListElements& _input)
+{
+    // Each list is a JSON array, as list params are bound: JSON_TABLE() rows of
+    // the same ordinal are one element.  Text comes out of JSON_TABLE() as
+    // utf8mb4_bin, so text keys match case sensitively
+    std::stringstream rows, str;
+
+    rows << "(SELECT ";
+    for (size_t i = 1; i <= _input.size(); ++i)
+        rows << (i > 1 ? ", " : "") << "dbbinder_j" << i << ".v AS dbbinder_p" << i;
+    rows << " FROM ";
+
+    for (size_t i = 1; i <= _input.size(); ++i)
+    {
+        const char *type;
+        switch(_input[i - 1].type)
+        {
+            case stInt:     type = "INT"; break;
+            case stUInt:    type = "INT UNSIGNED"; break;
+            case stInt64:   type = "BIGINT"; break;
+            case stUInt64:  type = "BIGINT UNSIGNED"; break;
+            case stFloat:
+            case stDouble:
+            case stUFloat:
+            case stUDouble: type = "DOUBLE"; break;
+            case stBool:    type = "BOOLEAN"; break;
+            case stText:    type = "LONGTEXT"; break;
+            default:
+                return std::string();
+        }
+
+        rows << (i > 1 ? ", " : "") << "JSON_TABLE(?, '$[*]' COLUMNS(n FOR ORDINALITY, v " << type << " PATH '$')) AS dbbinder_j" << i;
+    }
+
+    for (size_t i = 2; i <= _input.size(); ++i)
+        rows << (i > 2 ? " AND " : " WHERE ") << "dbbinder_j" << i << ".n = dbbinder_j1.n";
+    rows << ") AS dbbinder_rows";
+
+    std::vector<int>::const_iterator param = _params.begin() + _columns.size();
+    std::stringstream match;
+    for (ListString::const_iterator it = _keys.begin(); it != _keys.end(); ++it, ++param)
+        match << (it == _keys.begin() ? "" : " AND ") << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
+
+    if (_columns.empty())
+    {
+        str << "DELETE " << _table << " FROM " << _table << "\nJOIN " << rows.str() << " ON " << match.str();
+        return str.str();
+    }
+
+    str << "UPDATE " << _table << "\nJOIN " << rows.str() << " ON " << match.str() << "\nSET ";
+    param = _params.begin();
+    for (ListString::const_iterator it = _columns.begin(); it != _columns.end(); ++it, ++param)
+        str << (it == _columns.begin() ? "" : ", ") << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
+
+    return str.str();
 }
 
 void MySQLGenerator::addInsert(InsertElements _elements)
 {
     checkConnection();
+
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
     AbstractGenerator::addInsert(_elements);
 }
 
@@ -166,6 +316,8 @@ SQLTypes mySQLTypeToBinderType(enum_field_types _type)
 
         case MYSQL_TYPE_DECIMAL:
         case MYSQL_TYPE_NEWDECIMAL:
+            return stDecimal;
+
         case MYSQL_TYPE_FLOAT:
         case MYSQL_TYPE_DOUBLE:
             return stFloat;
@@ -194,16 +346,94 @@ SQLTypes mySQLTypeToBinderType(enum_field_types _type)
     };
 }
 
-void getFields(SelectElements *_elements, MYSQL_RES *_meta)
+// Labels of an ENUM column, from information_schema: "enum('a','it''s')" -> a, it's
+static std::vector<std::string> mysqlEnumLabels(MYSQL *_conn, const MYSQL_FIELD *_field)
+{
+    std::vector<std::string> result;
+
+    // Computed columns have no table to look the definition up in
+    if (!_field->org_table || !*_field->org_table || !_field->org_name || !_field->db)
+        return result;
+
+    std::string sql = "SELECT COLUMN_TYPE FROM information_schema.COLUMNS WHERE ";
+    const char *names[] = { "TABLE_SCHEMA", "TABLE_NAME", "COLUMN_NAME" };
+    const char *values[] = { _field->db, _field->org_table, _field->org_name };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        std::vector<char> escaped(strlen(values[i]) * 2 + 1);
+        mysql_real_escape_string(_conn, &escaped[0], values[i], strlen(values[i]));
+        sql += std::string(i ? " AND " : "") + names[i] + " = '" + &escaped[0] + "'";
+    }
+
+    if (mysql_query(_conn, sql.c_str()))
+        FATAL("MySQL: " << mysql_error(_conn));
+
+    MYSQL_RES *res = mysql_store_result(_conn);
+    MYSQL_ROW row = res ? mysql_fetch_row(res) : NULL;
+
+    if (row && row[0] && strncmp(row[0], "enum(", 5) == 0)
+    {
+        std::string label;
+        bool quoted = false;
+
+        for (const char *p = row[0] + 5; *p; ++p)
+        {
+            if (!quoted)
+                quoted = *p == '\'';
+            else if (*p == '\'' && p[1] == '\'')
+                label += *++p;
+            else if (*p == '\'')
+            {
+                result.push_back(label);
+                label.clear();
+                quoted = false;
+            }
+            else
+                label += *p;
+        }
+    }
+
+    if (res)
+        mysql_free_result(res);
+
+    return result;
+}
+
+void getFields(MYSQL *_conn, SelectElements *_elements, MYSQL_RES *_meta)
 {
     MYSQL_FIELD *field = mysql_fetch_field( _meta );
     SQLTypes type;
+    std::vector<std::string> labels;
 
     int i = 0;
     while( field )
     {
         type = mySQLTypeToBinderType(field->type);
+
+        // BOOL is TINYINT(1)
+        if (field->type == MYSQL_TYPE_TINY && field->length == 1)
+            type = stBool;
+
+        // The result metadata reports ENUMs as strings with ENUM_FLAG set
+        labels.clear();
+        if (field->type == MYSQL_TYPE_ENUM || (field->flags & ENUM_FLAG))
+            labels = mysqlEnumLabels(_conn, field);
+
+        if (!labels.empty())
+            type = stEnum;
+
+        // The display length counts the sign and the point too
+        if (type == stDecimal)
+        {
+            int precision = field->length - (field->decimals ? 1 : 0) - (field->flags & UNSIGNED_FLAG ? 0 : 1);
+            if (precision > DECIMAL_MAX_PRECISION)
+                FATAL(_elements->name << ": decimal field '" << field->name << "' has " << precision << " digits, more than the "
+                      << DECIMAL_MAX_PRECISION << " a DBBinderDecimal holds");
+        }
+
         _elements->output.push_back( SQLElement( field->name, type, i++, field->length ));
+        _elements->output.back().enumValues = labels;
 
         field = mysql_fetch_field( _meta );
     }
@@ -221,20 +451,126 @@ void MySQLGenerator::addSelect(SelectElements _elements)
 
     MYSQL_RES *meta = mysql_stmt_result_metadata(stmt);
 
-    getFields(&_elements, meta);
+    getFields(m_conn, &_elements, meta);
 
     mysql_free_result(meta);
     mysql_stmt_close(stmt);
 
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
     AbstractGenerator::addSelect(_elements);
 }
 
 void MySQLGenerator::addUpdate(UpdateElements _elements)
 {
     checkConnection();
+
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
     AbstractGenerator::addUpdate(_elements);
 }
 
+void MySQLGenerator::addDelete(DeleteElements _elements)
+{
+    checkConnection();
+
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
+    AbstractGenerator::addDelete(_elements);
+}
+
+void MySQLGenerator::explain(const AbstractElements& _elements)
+{
+    // EXPLAIN doesn't take '?' markers, each one is replaced by the param's
+    // default value (or a 1 without one) outside of quoted strings
+    std::string sql = "EXPLAIN ";
+    ListElements::const_iterator param = _elements.input.begin();
+    char quote = 0;
+
+    for(std::string::const_iterator c = _elements.sql.begin(); c != _elements.sql.end(); ++c)
+    {
+        if ( quote )
+        {
+            if ( *c == '\\' && c + 1 != _elements.sql.end() )
+                sql += *c++;
+            else if ( *c == quote )
+                quote = 0;
+        }
+        else if ( *c == '\'' || *c == '"' || *c == '`' )
+            quote = *c;
+        else if ( *c == '?' )
+        {
+            if ( param == _elements.input.end() || param->defaultValue.empty() )
+                sql += '1';
+            else
+            {
+                std::vector<char> escaped(param->defaultValue.length() * 2 + 1);
+                mysql_real_escape_string(m_conn, &escaped[0], param->defaultValue.c_str(), param->defaultValue.length());
+                sql += std::string("'") + &escaped[0] + '\'';
+            }
+
+            if ( param != _elements.input.end() )
+                ++param;
+            continue;
+        }
+
+        sql += *c;
+    }
+
+    if ( mysql_query(m_conn, sql.c_str()) )
+        FATAL(_elements.sql_location.file << ": EXPLAIN: " << mysql_error(m_conn));
+
+    MYSQL_RES *res = mysql_store_result(m_conn);
+    if ( !res )
+        FATAL(_elements.sql_location.file << ": EXPLAIN: " << mysql_error(m_conn));
+
+    // One row per table: id, select_type, table, partitions, type, possible_keys, key...
+    int table = -1, type = -1, key = -1, extra = -1, i = 0;
+    for(MYSQL_FIELD *field = mysql_fetch_field(res); field; field = mysql_fetch_field(res), i++)
+    {
+        std::string name = field->name;
+
+        if ( name == "table" )
+            table = i;
+        else if ( name == "type" )
+            type = i;
+        else if ( name == "key" )
+            key = i;
+        else if ( name == "Extra" )
+            extra = i;
+    }
+
+    std::string plan;
+    ListString scans;
+
+    #define COLUMN(IDX) std::string( IDX >= 0 && row[IDX] ? row[IDX] : "" )
+
+    while ( MYSQL_ROW row = mysql_fetch_row(res) )
+    {
+        std::string line = COLUMN(table) + ": " + COLUMN(type);
+
+        if ( !COLUMN(key).empty() )
+            line += " using " + COLUMN(key);
+        if ( !COLUMN(extra).empty() )
+            line += " (" + COLUMN(extra) + ')';
+
+        plan += line + '\n';
+
+        // ALL is a full table scan
+        if ( COLUMN(type) == "ALL" )
+            scans.push_back(line);
+    }
+
+    #undef COLUMN
+
+    mysql_free_result(res);
+
+    checkQueryPlan(_elements, plan, scans);
+}
+
 struct MySQLInBufferHolder
 {    
 public:
@@ -264,6 +600,7 @@ public:
             case stInt64:
             case stUInt:
             case stUInt64:
+            case stBool:
             {
                 intBuffer = new int(0);
                 break;
@@ -273,6 +610,7 @@ public:
             case stDouble:
             case stUFloat:
             case stUDouble:
+            case stDecimal:
             {
                 doubleBuffer = new double(0);
                 break;
@@ -343,6 +681,7 @@ void MySQLGenerator::addStoredProcedure(StoredProcedureElements _elements)
             case stInt64:
             case stUInt:
             case stUInt64:
+            case stBool:
             {
                 int *val = inBuffers.rbegin()->intBuffer;
                 
@@ -360,6 +699,7 @@ void MySQLGenerator::addStoredProcedure(StoredProcedureElements _elements)
             case stDouble:
             case stUFloat:
             case stUDouble:
+            case stDecimal:
             {
                 double *val = inBuffers.rbegin()->doubleBuffer;
                 
@@ -412,7 +752,7 @@ void MySQLGenerator::addStoredProcedure(StoredProcedureElements _elements)
     MYSQL_RES *result = mysql_store_result(m_conn);
     MYSQL_RES *meta = mysql_stmt_result_metadata(stmt);
     
-    getFields(&_elements, meta);
+    getFields(m_conn, &_elements, meta);
 
     mysql_free_result(result);
     mysql_stmt_close(stmt);
@@ -426,6 +766,11 @@ bool MySQLGenerator::needIOBuffers() const
     return true;
 }
 
+static bool isUnsigned(SQLTypes _type)
+{
+    return _type == stUInt || _type == stUInt64;
+}
+
 void getMySQLTypes(SQLTypes _type, std::string& _lang, std::string& _mysql)
 {
     switch( _type )
@@ -438,16 +783,44 @@ void getMySQLTypes(SQLTypes _type, std::string& _lang, std::string& _mysql)
             _mysql = "MYSQL_TYPE_LONG";
             break;
 
+        case stUInt:
+            _lang = "unsigned int";
+            _mysql = "MYSQL_TYPE_LONG";
+            break;
+
+        case stInt64:
+            _lang = "long long";
+            _mysql = "MYSQL_TYPE_LONGLONG";
+            break;
+
+        case stUInt64:
+            _lang = "unsigned long long";
+            _mysql = "MYSQL_TYPE_LONGLONG";
+            break;
+
         case stFloat:
+        case stUFloat:
             _lang = "float";
             _mysql = "MYSQL_TYPE_FLOAT";
             break;
 
         case stDouble:
+        case stUDouble:
             _lang = "double";
             _mysql = "MYSQL_TYPE_DOUBLE";
             break;
 
+        case stBool:
+            _lang = "signed char";
+            _mysql = "MYSQL_TYPE_TINY";
+            break;
+
+        case stDecimal:
+            // Sent and received as text, never as a C float
+            _lang = "char";
+            _mysql = "MYSQL_TYPE_NEWDECIMAL";
+            break;
+
         case stTimeStamp:
             _lang = "MYSQL_TIME";
             _mysql = "MYSQL_TYPE_TIMESTAMP";
@@ -480,92 +853,148 @@ void getMySQLTypes(SQLTypes _type, std::string& _lang, std::string& _mysql)
 
 void MySQLGenerator::addInBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements *_elements)
 {
+    /*
+        The binds are members set up once, in the constructor.  Scalars are
+        copied into members and lengths/null flags are read through pointers,
+        so only a text/blob parameter whose address changed forces another
+        mysql_stmt_bind_param (<prefix>InBound is cleared).
+    */
     std::string langType, myType;
+    std::string prefix = stmtPrefix(_type);
+    std::string buffer = prefix + "InBuffer";
     int index = 0;
 
-    if (_elements->input.empty() || _elements->input.size() == 0)
+    if (_elements->input.empty())
     {
         TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_IN_FIELDS_BUFFERS);
-        buffDict->SetValue(tpl_BUFFER_DECLARE, "MYSQL_BIND inBuffer[0];\n\n" );
+        buffDict->SetValue(tpl_BUFFER_DECLARE, "MYSQL_BIND " + buffer + "[1];\nbool " + prefix + "InBound;\n\n" );
+        buffDict->SetValue(tpl_BUFFER_INITIALIZE, "memset(" + buffer + ", 0, sizeof(" + buffer + "));\n" + prefix + "InBound = false;\n\n" );
+        buffDict->SetValue(tpl_BUFFER_FREE, prefix + "InBound = false;\n" );
     }
     else
     {
         foreach(SQLElement field, _elements->input)
         {
-            std::stringstream decl, init;
+            std::stringstream decl, init, alloc, free;
+            std::string param = prefix + "Param" + field.name;
 
             getMySQLTypes( field.type, langType, myType );
 
+            // Lists go as one JSON array text, read by JSON_TABLE(?, ...) in the statement
+            if ( field.list )
+                myType = "MYSQL_TYPE_STRING";
+
             if ( index == 0 )
             {
-                decl << "MYSQL_BIND inBuffer[" << _elements->input.size() << "];\n\n";
-                init << "memset(inBuffer, 0, sizeof(inBuffer));\n\n";
+                decl << "MYSQL_BIND " << buffer << "[" << _elements->input.size() << "];\n"
+                     << "bool " << prefix << "InBound;\n\n";
+                init << "memset(" << buffer << ", 0, sizeof(" << buffer << "));\n"
+                     << prefix << "InBound = false;\n\n";
+                free << prefix << "InBound = false;\n";
             }
 
-            if (_type == sstSelect || _type == sstStoredProcedure)
-                decl << langType << " m_param" << field.name << ";\n";
+            decl << "long unsigned " << param << "Length;\n";
+            decl << "my_bool " << param << "IsNull;\n";
 
-            decl << "long unsigned m_param" << field.name << "Length;\n";
-            decl << "my_bool m_param" << field.name << "IsNull;\n";
+            init << buffer << "[" << index << "].buffer_type = " << myType << ";\n";
 
-            init << "inBuffer[" << index << "].buffer_type = " << myType << ";\n";
+            if ( field.list )
+            {
+                decl << "std::string " << param << "List;\n";
+
+                alloc << "dbbinderJSONArray(" << param << "List, _" << field.name << ");\n"
+                    << param << "IsNull = 0;\n"
+                    << param << "Length = " << param << "List.size();\n\n";
 
-            switch( field.type )
+                alloc << "if (" << buffer << "[" << index << "].buffer != " << param << "List.data())\n{\n"
+                    << buffer << "[" << index << "].buffer = const_cast<char*>(" << param << "List.data());\n"
+                    << prefix << "InBound = false;\n"
+                    << "}\n";
+            }
+            else switch( field.type )
             {
                 case stBlob:
                 {
-                    init << "m_param" << field.name << "IsNull = (_" << field.name << ") ? 0 : 1;\n"
-                        << "m_param" << field.name << "Length = (_" << field.name << ") ? _" << field.name << "->size() : 0;\n\n";
-
-                    init << "inBuffer[" << index << "].buffer = reinterpret_cast<void*>(_" << field.name << "->data());\n";
+                    alloc << param << "IsNull = (_" << field.name << ") ? 0 : 1;\n"
+                        << param << "Length = (_" << field.name << ") ? _" << field.name << "->size() : 0;\n\n";
+
+                    alloc << "{\n"
+                        << "void *data = (_" << field.name << " && !_" << field.name << "->empty()) ? reinterpret_cast<void*>(&(*_" << field.name << ")[0]) : NULL;\n"
+                        << "if (" << buffer << "[" << index << "].buffer != data)\n{\n"
+                        << buffer << "[" << index << "].buffer = data;\n"
+                        << prefix << "InBound = false;\n"
+                        << "}\n}\n";
                     break;
                 }
                 case stDate:
                 case stTime:
                 case stTimeStamp:
                 {
-                    decl << "MYSQL_TIME m_param" << field.name << "MyTime;\n";
+                    decl << "MYSQL_TIME " << param << "MyTime;\n";
 
-                    init << "m_param" << field.name << "IsNull = (_" << field.name << ".is_not_a_date_time()) ? 1 : 0;\n"
-                        << "m_param" << field.name << "Length = sizeof(MYSQL_TIME);\n"
-                        << "m_param" << field.name << "MyTime = dbbinderConvertTime(_" << field.name << ");\n\n";
+                    init << buffer << "[" << index << "].buffer = reinterpret_cast<void *>(&" << param << "MyTime);\n";
 
-                    init << "inBuffer[" << index << "].buffer = reinterpret_cast<void *>(&m_param" << field.name << "MyTime);\n";
+                    const char *timeType = field.type == stDate ? "MYSQL_TIMESTAMP_DATE" :
+                                           field.type == stTime ? "MYSQL_TIMESTAMP_TIME" : "MYSQL_TIMESTAMP_DATETIME";
+
+                    alloc << param << "IsNull = dbbinderTimeIsNull(_" << field.name << ") ? 1 : 0;\n"
+                        << param << "Length = sizeof(MYSQL_TIME);\n"
+                        << param << "MyTime = dbbinderMicrosToMyTime(dbbinderToMicros(_" << field.name << "), " << timeType << ");\n\n";
+                    break;
+                }
+                case stDecimal:
+                {
+                    decl << langType << " " << param << "[DBBinderDecimal::STRING_SIZE];\n";
+
+                    init << buffer << "[" << index << "].buffer = reinterpret_cast<void *>(" << param << ");\n"
+                         << buffer << "[" << index << "].buffer_length = DBBinderDecimal::STRING_SIZE;\n";
+
+                    alloc << param << "IsNull = 0;\n"
+                        << param << "Length = strlen(_" << field.name << ".format(" << param << "));\n\n";
                     break;
                 }
                 case stText:
                 {
-                    init << "m_param" << field.name << "IsNull = (_" << field.name << ") ? 0 : 1;\n"
-                        << "m_param" << field.name << "Length = (_" << field.name << ") ? strlen(_" << field.name << ") : 0;\n\n";
+                    alloc << param << "IsNull = (_" << field.name << ") ? 0 : 1;\n"
+                        << param << "Length = (_" << field.name << ") ? strlen(_" << field.name << ") : 0;\n\n";
 
-                    init << "inBuffer[" << index << "].buffer = const_cast<void*>(reinterpret_cast<const void *>(_" << field.name << "));\n";
+                    alloc << "if (" << buffer << "[" << index << "].buffer != reinterpret_cast<const void *>(_" << field.name << "))\n{\n"
+                        << buffer << "[" << index << "].buffer = const_cast<void*>(reinterpret_cast<const void *>(_" << field.name << "));\n"
+                        << prefix << "InBound = false;\n"
+                        << "}\n";
                     break;
                 }
                 default:
                 {
-                    init << "m_param" << field.name << "IsNull = 0;\n"
-                        << "m_param" << field.name << "Length = 0;\n\n";
+                    decl << langType << " " << param << ";\n";
+
+                    init << buffer << "[" << index << "].buffer = reinterpret_cast<void *>(&" << param << ");\n";
+                    if (isUnsigned(field.type))
+                        init << buffer << "[" << index << "].is_unsigned = 1;\n";
 
-                    init << "inBuffer[" << index << "].buffer = reinterpret_cast<void *>(&_" << field.name << ");\n";
+                    alloc << param << "IsNull = 0;\n"
+                        << param << "Length = sizeof(" << langType << ");\n"
+                        << param << " = _" << field.name << ";\n\n";
                     break;
                 }
             }
 
-
-            init << "inBuffer[" << index << "].is_null = &m_param" << field.name << "IsNull;\n"
-                    << "inBuffer[" << index << "].length = &m_param" << field.name << "Length;\n"
+            init << buffer << "[" << index << "].is_null = &" << param << "IsNull;\n"
+                    << buffer << "[" << index << "].length = &" << param << "Length;\n"
                     << "\n";
 
             TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_IN_FIELDS_BUFFERS);
             buffDict->SetValue(tpl_BUFFER_DECLARE, decl.str() );
-            buffDict->SetValue(tpl_BUFFER_ALLOC, init.str() );
+            buffDict->SetValue(tpl_BUFFER_INITIALIZE, init.str() );
+            buffDict->SetValue(tpl_BUFFER_ALLOC, alloc.str() );
+            buffDict->SetValue(tpl_BUFFER_FREE, free.str() );
 
             ++index;
         }
     }
 }
 
-void MySQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictionary *_subDict, const AbstractElements *_elements)
+void MySQLGenerator::addOutBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements *_elements)
 {
     std::string langType, myType;
     int index = 0;
@@ -578,8 +1007,22 @@ void MySQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictiona
 
         if ( index == 0 )
         {
-            decl << "MYSQL_BIND selOutBuffer[" << _elements->output.size() << "];\n\n";
+            // selOutInline keeps the binds as set up here, see mysqlStoreResult
+            decl << "MYSQL_BIND selOutBuffer[" << _elements->output.size() << "];\n"
+                 << "MYSQL_BIND selOutInline[" << _elements->output.size() << "];\n\n";
             init << "memset(selOutBuffer, 0, sizeof(selOutBuffer));\n\n";
+
+            if (_type == sstSelect)
+            {
+                // Read by the select's prepare and execute, see mysqlSetResultMode
+                const SelectElements *select = static_cast<const SelectElements*>(_elements);
+                const char *mode = select->resultMode == srmStore ? "DBBINDER_MYSQL_STORE" :
+                                   select->resultMode == srmCursor ? "DBBINDER_MYSQL_CURSOR" : "DBBINDER_MYSQL_STREAM";
+
+                decl << "static const int s_selectResultMode = " << mode << ";\n"
+                     << "static const unsigned long s_selectPrefetchRows = " << select->prefetchRows << ";\n"
+                     << "std::vector<char> m_selectStored;\n\n";
+            }
         }
 
         decl << "my_bool m_" << field.name << "IsNull;\n"
@@ -593,7 +1036,28 @@ void MySQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictiona
             }
             case stText:
             {
-                decl << langType << " m_buff" << field.name << "[" << field.length + 1 << "];\n";
+                // Streamed text is read with mysql_stmt_fetch_column, like blobs
+                if (field.streamed)
+                    break;
+
+                // Inline buffers are capped; longer values go to m_<name>Overflow
+                decl << langType << " m_buff" << field.name << "[DBBINDER_MYSQL_TEXT_LENGTH(" << field.length << ") + 1];\n"
+                     << "my_bool m_" << field.name << "Error;\n"
+                     << "std::vector<char> m_" << field.name << "Overflow;\n";
+                init << "selOutBuffer[" << index << "].buffer_length = DBBINDER_MYSQL_TEXT_LENGTH(" << field.length << ");\n"
+                     << "selOutBuffer[" << index << "].error = &m_" << field.name << "Error;\n";
+                break;
+            }
+            case stDecimal:
+            {
+                decl << langType << " m_buff" << field.name << "[DBBinderDecimal::STRING_SIZE];\n";
+                init << "selOutBuffer[" << index << "].buffer_length = DBBinderDecimal::STRING_SIZE;\n";
+                break;
+            }
+            case stEnum:
+            {
+                // Fetched by label; the length already covers the longest one
+                decl << langType << " m_buff" << field.name << "[" << field.length << " + 1];\n";
                 init << "selOutBuffer[" << index << "].buffer_length = " << field.length << ";\n";
                 break;
             }
@@ -606,11 +1070,12 @@ void MySQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictiona
 
         init << "selOutBuffer[" << index << "].buffer_type = " << myType << ";\n";
 
-        if (field.type != stBlob)
+        if (field.type != stBlob && !field.streamed)
             init << "selOutBuffer[" << index << "].buffer = reinterpret_cast<void *>(&m_buff" << field.name << ");\n";
 
         init << "selOutBuffer[" << index << "].is_null = &m_" << field.name << "IsNull;\n"
                 << "selOutBuffer[" << index << "].length = &m_" << field.name << "Length;\n"
+                << "selOutInline[" << index << "] = selOutBuffer[" << index << "];\n"
                 << "\n";
 
         TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS_BUFFERS);
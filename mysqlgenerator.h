@@ -43,9 +43,17 @@ protected:
     virtual std::string getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamLength(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamRead(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                     const ListString& _keys, const ListString& _updates) __C11_OVERRIDE;
+    virtual std::string getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                   const std::vector<int>& _params, const ListElements& _input) __C11_OVERRIDE;
 
     virtual bool   needIOBuffers() const __C11_OVERRIDE;
 
+    void explain(const AbstractElements& _elements);
+
     virtual void addInBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements* _elements) __C11_OVERRIDE;
     virtual void addOutBuffers(SQLStatementTypes _type, TemplateDictionary *_subDict, const AbstractElements* _elements) __C11_OVERRIDE;
 
@@ -53,6 +61,7 @@ public:
     virtual void addInsert(InsertElements _elements) __C11_OVERRIDE;
     virtual void addSelect(SelectElements _elements) __C11_OVERRIDE;
     virtual void addUpdate(UpdateElements _elements) __C11_OVERRIDE;
+    virtual void addDelete(DeleteElements _elements) __C11_OVERRIDE;
     virtual void addStoredProcedure(StoredProcedureElements _elements) __C11_OVERRIDE;
 };
 
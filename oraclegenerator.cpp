@@ -196,6 +196,9 @@ bool OracleGenerator::checkConnection()
 
 String OracleGenerator::getBind(SQLStatementTypes _type, const ListElements::iterator & _item, int _index)
 {
+    if ( _item->list )
+        FATAL("'" << _item->name << "': list params are not supported by the Oracle generator");
+
     String langType, oraType;
     getOracleTypes( _item->type, langType, oraType );
 
@@ -224,6 +227,38 @@ String OracleGenerator::getIsNull(SQLStatementTypes _type, const ListElements::i
     FATAL("Not implemented!");
 }
 
+String OracleGenerator::getUpsertSQL(const String& _table, const ListString& _columns, const ListString& _values,
+                                     const ListString& _keys, const ListString& _updates)
+{
+    // The values are selected from dual once, so the binds keep their order
+    std::stringstream result;
+    ListString::const_iterator it, value;
+
+    result << "MERGE INTO " << _table << " dst\nUSING (SELECT ";
+    for ( it = _columns.begin(), value = _values.begin(); it != _columns.end(); ++it, ++value )
+        result << ( it == _columns.begin() ? "" : ", " ) << *value << " " << *it;
+
+    result << " FROM dual) src\nON (";
+    for ( it = _keys.begin(); it != _keys.end(); ++it )
+        result << ( it == _keys.begin() ? "" : " AND " ) << "dst." << *it << " = src." << *it;
+    result << ")\n";
+
+    if ( !_updates.empty() )
+    {
+        result << "WHEN MATCHED THEN UPDATE SET ";
+        for ( it = _updates.begin(); it != _updates.end(); ++it )
+            result << ( it == _updates.begin() ? "" : ", " ) << "dst." << *it << " = src." << *it;
+        result << "\n";
+    }
+
+    result << "WHEN NOT MATCHED THEN INSERT (" << stringJoin( _columns, ", " ) << ")\nVALUES (";
+    for ( it = _columns.begin(); it != _columns.end(); ++it )
+        result << ( it == _columns.begin() ? "" : ", " ) << "src." << *it;
+    result << ")";
+
+    return result.str();
+}
+
 void OracleGenerator::addSelect(SelectElements _elements)
 {
     checkConnection();
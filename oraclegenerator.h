@@ -48,6 +48,8 @@ protected:
     virtual String getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual String getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual String getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual String getUpsertSQL(const String& _table, const ListString& _columns, const ListString& _values,
+                                const ListString& _keys, const ListString& _updates) __C11_OVERRIDE;
 
     virtual bool needIOBuffers() const __C11_OVERRIDE;
 
@@ -107,6 +107,9 @@
 #define FDW_HANDLEROID          3115
 #define ANYRANGEOID             3831
 
+// OIDs below this one are built in
+#define FIRSTNORMALOBJECTID     16384
+
 namespace DBBinder
 {
 
@@ -192,12 +195,16 @@ PGTypePair getPgTypes(SQLTypes _type)
         case stDouble:
         case stUDouble:
             return PGTypePair( "float8", FLOAT8OID );
+        case stBool:
+            return PGTypePair( "bool", BOOLOID );
+        case stDecimal:
+            return PGTypePair( "DBBinderDecimal", NUMERICOID );
         case stTimeStamp:
-            return PGTypePair( "float4", TIMESTAMPTZOID );
+            return PGTypePair( "int64_t", TIMESTAMPTZOID );
         case stTime:
-            return PGTypePair( "float4", TIMEOID );
+            return PGTypePair( "int64_t", TIMEOID );
         case stDate:
-            return PGTypePair( "float4", DATEOID );
+            return PGTypePair( "int32_t", DATEOID );
         case stText:
             return PGTypePair( "string", VARCHAROID );
         case stBlob:
@@ -211,6 +218,8 @@ SQLTypes getSQLTypes(Oid _pgType)
 {
     switch(_pgType)
     {
+        case BOOLOID:
+            return stBool;
         case INT4OID:
             return stInt;
         case INT8OID:
@@ -219,6 +228,8 @@ SQLTypes getSQLTypes(Oid _pgType)
             return stFloat;
         case FLOAT8OID:
             return stDouble;
+        case NUMERICOID:
+            return stDecimal;
         case TIMESTAMPTZOID:
         case TIMESTAMPOID:
             return stTimeStamp;
@@ -249,6 +260,26 @@ std::string getStmtType(SQLStatementTypes _type)
     };
 }
 
+// Labels of an enum type, in declaration order; empty for any other type
+static std::vector<std::string> pgEnumLabels(PGconn *_conn, Oid _type)
+{
+    std::vector<std::string> result;
+
+    if (_type < FIRSTNORMALOBJECTID)
+        return result;
+
+    std::stringstream sql;
+    sql << "SELECT enumlabel FROM pg_enum WHERE enumtypid = " << _type << " ORDER BY enumsortorder";
+
+    PQResult res(PQexec(_conn, sql.str().c_str()));
+    PGResultCheck(_conn, res);
+
+    for (int i = 0; i < PQntuples(res); ++i)
+        result.push_back(PQgetvalue(res, i, 0));
+
+    return result;
+}
+
 PostgreSQLGenerator::PostgreSQLGenerator(): 
     AbstractGenerator(), 
     m_conn(NULL)
@@ -303,6 +334,47 @@ std::string PostgreSQLGenerator::getBind(SQLStatementTypes /*_type*/, const List
 {
     std::stringstream str;
 
+    if ( _item->list )
+    {
+        // Numbers and booleans go as binary arrays, text as an array literal; the
+        // statement reads them with = ANY($n)
+        std::string encode;
+        switch(_item->type)
+        {
+            case stInt:
+            case stUInt:
+                encode = "pqBinaryArray<int32_t>(m_buff" + _item->name + ", _" + _item->name + ", PQ_INT4_OID)";
+                break;
+            case stInt64:
+            case stUInt64:
+                encode = "pqBinaryArray<int64_t>(m_buff" + _item->name + ", _" + _item->name + ", PQ_INT8_OID)";
+                break;
+            case stFloat:
+            case stDouble:
+            case stUFloat:
+            case stUDouble:
+                encode = "pqBinaryArray<double>(m_buff" + _item->name + ", _" + _item->name + ", PQ_FLOAT8_OID)";
+                break;
+            case stBool:
+                encode = "pqBinaryArray<bool>(m_buff" + _item->name + ", _" + _item->name + ", PQ_BOOL_OID)";
+                break;
+            case stText:
+                str <<
+                    "paramValues[" << _index << "] = pqTextArray(m_buff" << _item->name << ", _" << _item->name << ");\n"
+                    "paramLengths[" << _index << "] = 0;\n"
+                    "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_TEXT;";
+                return str.str();
+            default:
+                FATAL(__FILE__  << ':' << __LINE__ << ": Invalid list param type: '" << _item->name << "': " << _item->type);
+        }
+
+        str <<
+            "paramValues[" << _index << "] = " << encode << ";\n"
+            "paramLengths[" << _index << "] = m_buff" << _item->name << ".size();\n"
+            "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_BINARY;";
+        return str.str();
+    }
+
     switch(_item->type)
     {
         case stInt:
@@ -341,17 +413,47 @@ std::string PostgreSQLGenerator::getBind(SQLStatementTypes /*_type*/, const List
                 "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_BINARY;";
             break;
         }
+        case stBool:
+        {
+            str <<
+                "m_buff" << _item->name << " = _" << _item->name << " ? 1 : 0;\n"
+                "paramValues[" << _index << "] = &m_buff" << _item->name << ";\n"
+                "paramLengths[" << _index << "] = sizeof(m_buff" << _item->name << ");\n"
+                "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_BINARY;";
+            break;
+        }
+        case stTimeStamp:
+        case stTime:
+        case stDate:
+        {
+            if ( _item->type == stDate )
+                str << "m_buff" << _item->name << " = htonl(pqMicrosToDate(dbbinderToMicros(_" << _item->name << ")));\n";
+            else
+                str << "m_buff" << _item->name << " = htobe64(dbbinderToMicros(_" << _item->name << ")" << (_item->type == stTimeStamp ? " - PQ_EPOCH_MICROS" : "") << ");\n";
+
+            str <<
+                "paramValues[" << _index << "] = dbbinderTimeIsNull(_" << _item->name << ") ? NULL : (const char*)(&m_buff" << _item->name << ");\n"
+                "paramLengths[" << _index << "] = sizeof(m_buff" << _item->name << ");\n"
+                "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_BINARY;";
+            break;
+        }
+
         case stFloat:
         case stDouble:
         case stUFloat:
         case stUDouble:
-
-        case stTimeStamp:
-        case stTime:
-        case stDate:
             FATAL(__FILE__  << ':' << __LINE__ << ": Invalid param type: '" << _item->name << "': " << _item->type);
             break;
 
+        case stDecimal:
+        {
+            str <<
+                "paramValues[" << _index << "] = _" << _item->name << ".format(m_buff" << _item->name << ");\n"
+                "paramLengths[" << _index << "] = 0;\n"
+                "paramFormats[" << _index << "] = PQ_RESULT_FORMAT_TEXT;";
+            break;
+        }
+
         case stText:
         {
             str <<
@@ -373,7 +475,7 @@ std::string PostgreSQLGenerator::getBind(SQLStatementTypes /*_type*/, const List
 std::string PostgreSQLGenerator::getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index)
 {
     std::stringstream str;
-    str << "if (!m_isNull" << _item->name << ")\n{";
+    str << "if (!" << getIsNull(_type, _item, _index) << ")\n{";
 
     switch(_item->type)
     {
@@ -392,16 +494,37 @@ std::string PostgreSQLGenerator::getReadValue(SQLStatementTypes _type, const Lis
             str << "m_" << _item->name << " = be64toh(*((int32_t*)PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ")));";
             break;
             
+        case stBool:
+            str << "m_" << _item->name << " = *PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ") != 0;";
+            break;
+
+        case stEnum:
+            str << "fromString(PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << "), m_" << _item->name << ");";
+            break;
+
+        case stTimeStamp:
+            str << "dbbinderFromMicros(pqInt64(PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ")) + PQ_EPOCH_MICROS, m_" << _item->name << ");";
+            break;
+
+        case stTime:
+            str << "dbbinderFromMicros(pqInt64(PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ")), m_" << _item->name << ");";
+            break;
+
+        case stDate:
+            str << "dbbinderFromMicros((pqInt32(PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ")) + PQ_EPOCH_DAYS) * PQ_DAY_MICROS, m_" << _item->name << ");";
+            break;
+
         case stFloat:
         case stDouble:
         case stUFloat:
         case stUDouble:
-        case stTimeStamp:
-        case stTime:
-        case stDate:
             FATAL(__FILE__  << ':' << __LINE__ << ": Invalid param type: '" << _item->name << "': " << sqlTypeToName(_item->type));
             break;
 
+        case stDecimal:
+            str << "m_" << _item->name << " = pqNumericToDecimal(PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << "));";
+            break;
+
         case stText:
             str << "m_" << _item->name << " = PQgetvalue(_parent->m_" << getStmtType(_type) << "Stmt.get(), _parent->m_rowNum, " << _index << ");";
             break;
@@ -423,6 +546,118 @@ std::string PostgreSQLGenerator::getIsNull(SQLStatementTypes _type, const ListEl
     return str.str();
 }
 
+std::string PostgreSQLGenerator::getStreamLength(const ListElements::iterator& /*_item*/, int _index)
+{
+    std::stringstream str;
+    str << "return PQgetlength(m_selectStmt.get(), m_rowNum, " << _index << ");";
+    return str.str();
+}
+
+std::string PostgreSQLGenerator::getStreamRead(const ListElements::iterator& /*_item*/, int _index)
+{
+    // Not a real stream: libpq already holds the whole result, this only
+    // spares the copy into the row
+    std::stringstream str;
+    str << "size_t size = PQgetlength(m_selectStmt.get(), m_rowNum, " << _index << ");\n"
+        << "if (_offset >= size)\n"
+        << "    return 0;\n"
+        << "size_t count = std::min(_length, size - _offset);\n"
+        << "memcpy(_buffer, PQgetvalue(m_selectStmt.get(), m_rowNum, " << _index << ") + _offset, count);\n"
+        << "return count;";
+    return str.str();
+}
+
+std::string PostgreSQLGenerator::getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                              const ListString& _keys, const ListString& _updates)
+{
+    // ON CONFLICT needs PostgreSQL 9.5, and a unique index or constraint on exactly _keys
+    std::stringstream str;
+    str << "INSERT INTO " << _table << " (" << stringJoin(_columns, ", ") << ")\n"
+        << "VALUES (" << stringJoin(_values, ", ") << ")\n"
+        << "ON CONFLICT (" << stringJoin(_keys, ", ") << ") DO ";
+
+    if (_updates.empty())
+        str << "NOTHING";
+    else
+    {
+        str << "UPDATE SET ";
+        for (ListString::const_iterator it = _updates.begin(); it != _updates.end(); ++it)
+            str << (it == _updates.begin() ? "" : ", ") << *it << " = EXCLUDED." << *it;
+    }
+    return str.str();
+}
+
+std::string PostgreSQLGenerator::getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                            const std::vector<int>& _params, const ListElements& _input)
+{
+    // The casts match the arrays getBind() sends; unnest() zips them into one
+    // row per element
+    ListString arrays;
+    for (ListElements::const_iterator it = _input.begin(); it != _input.end(); ++it)
+    {
+        std::stringstream array;
+        array << '$' << arrays.size() + 1 << "::";
+        switch(it->type)
+        {
+            case stInt:
+            case stUInt:
+                array << "int4[]";
+                break;
+            case stInt64:
+            case stUInt64:
+                array << "int8[]";
+                break;
+            case stFloat:
+            case stDouble:
+            case stUFloat:
+            case stUDouble:
+                array << "float8[]";
+                break;
+            case stBool:
+                array << "bool[]";
+                break;
+            case stText:
+                array << "text[]";
+                break;
+            default:
+                return std::string();
+        }
+        arrays.push_back(array.str());
+    }
+
+    std::stringstream str;
+    if (_columns.empty() && _keys.size() == 1)
+    {
+        str << "DELETE FROM " << _table << " WHERE " << _keys.front() << " = ANY(" << arrays[_params.front()] << ")";
+        return str.str();
+    }
+
+    std::string rows = "unnest(" + stringJoin(arrays, ", ") + ") AS dbbinder_rows(";
+    for (size_t i = 1; i <= arrays.size(); ++i)
+    {
+        std::stringstream column;
+        column << (i > 1 ? ", " : "") << "dbbinder_p" << i;
+        rows += column.str();
+    }
+    rows += ")";
+
+    std::vector<int>::const_iterator param = _params.begin();
+    if (_columns.empty())
+        str << "DELETE FROM " << _table << "\nUSING " << rows << "\nWHERE ";
+    else
+    {
+        str << "UPDATE " << _table << " SET ";
+        for (ListString::const_iterator it = _columns.begin(); it != _columns.end(); ++it, ++param)
+            str << (it == _columns.begin() ? "" : ", ") << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
+        str << "\nFROM " << rows << "\nWHERE ";
+    }
+
+    for (ListString::const_iterator it = _keys.begin(); it != _keys.end(); ++it, ++param)
+        str << (it == _keys.begin() ? "" : " AND ") << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
+
+    return str.str();
+}
+
 void PostgreSQLGenerator::addSelect(SelectElements _elements)
 {
     checkConnection();
@@ -441,17 +676,106 @@ void PostgreSQLGenerator::addSelect(SelectElements _elements)
 #ifndef NDEBUG
         std::cerr << "Field(" << i << "): '" << PQfname(res, i) << "' = " << PQftype(res, i) << std::flush;
 #endif
-        SQLTypes type = getSQLTypes(PQftype(res, i));
+        std::vector<std::string> labels = pgEnumLabels(m_conn, PQftype(res, i));
+        SQLTypes type = labels.empty() ? getSQLTypes(PQftype(res, i)) : stEnum;
 #ifndef NDEBUG
         std::cerr << " - " << sqlTypeToName(type) << std::endl;
 #endif
 
+        // numeric(p, s) has the typmod ((p << 16) | s) + 4, a bare numeric -1
+        int modifier = PQfmod(res, i);
+        if (type == stDecimal && modifier < 4)
+            WARNING(_elements.name << ": numeric field '" << PQfname(res, i) << "' has no precision, values over "
+                    << DECIMAL_MAX_PRECISION << " digits will throw")
+        else if (type == stDecimal && ((modifier - 4) >> 16) > DECIMAL_MAX_PRECISION)
+            FATAL(_elements.name << ": numeric field '" << PQfname(res, i) << "' has " << ((modifier - 4) >> 16) << " digits, more than the "
+                  << DECIMAL_MAX_PRECISION << " a DBBinderDecimal holds");
+
         _elements.output.push_back( SQLElement( PQfname(res, i), type, i, PQfsize(res, i) ));
+        _elements.output.back().enumValues = labels;
     }
 
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
     AbstractGenerator::addSelect(_elements);
 }
 
+void PostgreSQLGenerator::addUpdate(UpdateElements _elements)
+{
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
+    AbstractGenerator::addUpdate(_elements);
+}
+
+void PostgreSQLGenerator::addInsert(InsertElements _elements)
+{
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
+    AbstractGenerator::addInsert(_elements);
+}
+
+void PostgreSQLGenerator::addDelete(DeleteElements _elements)
+{
+    if ( !optPlanCheck.empty() )
+        explain(_elements);
+
+    AbstractGenerator::addDelete(_elements);
+}
+
+void PostgreSQLGenerator::explain(const AbstractElements& _elements)
+{
+    checkConnection();
+
+    // plan_cache_mode is from 12 on
+    if ( PQserverVersion(m_conn) < 120000 )
+    {
+        WARNING(_elements.sql_location.file << ": query plans need PostgreSQL 12 or newer");
+        return;
+    }
+
+    PQResult res;
+
+    // The generated code runs prepared statements, so explain the generic plan: the
+    // one that doesn't depend on the parameter values
+    res = PQexec(m_conn, "SET plan_cache_mode = force_generic_plan");
+    PGCommandCheck(m_conn, res);
+
+    res = PQprepare(m_conn, "dbbinder_plan", _elements.sql.c_str(), 0, 0);
+    PGCommandCheck(m_conn, res);
+
+    std::string sql = "EXPLAIN EXECUTE dbbinder_plan";
+    for(size_t i = 0; i < _elements.input.size(); i++)
+        sql += i ? ", NULL" : "(NULL";
+    if ( !_elements.input.empty() )
+        sql += ')';
+
+    res = PQexec(m_conn, sql.c_str());
+    PGResultCheck(m_conn, res);
+
+    std::string plan;
+    ListString scans;
+
+    for(int i = 0; i < PQntuples(res); i++)
+    {
+        std::string line = PQgetvalue(res, i, 0);
+        plan += line + '\n';
+
+        if ( line.find("Seq Scan on ") != std::string::npos )
+            scans.push_back(line.substr(line.find_first_not_of(" ->")));
+    }
+
+    res = PQexec(m_conn, "DEALLOCATE dbbinder_plan");
+    PGCommandCheck(m_conn, res);
+
+    res = PQexec(m_conn, "RESET plan_cache_mode");
+    PGCommandCheck(m_conn, res);
+
+    checkQueryPlan(_elements, plan, scans);
+}
+
 bool PostgreSQLGenerator::needIOBuffers() const
 {
     return true;
@@ -459,35 +783,39 @@ bool PostgreSQLGenerator::needIOBuffers() const
 
 void PostgreSQLGenerator::addInBuffers(SQLStatementTypes /*_type*/, TemplateDictionary *_subDict, const AbstractElements* _elements)
 {
-    if ( !_elements->input.empty() )
-    {
-        TemplateDictionary *buffDict= _subDict->AddSectionDictionary(tpl_STMT_IN_FIELDS_BUFFERS);
+    TemplateDictionary *buffDict= _subDict->AddSectionDictionary(tpl_STMT_IN_FIELDS_BUFFERS);
 
-        std::stringstream str;
+    std::stringstream str;
 
-        int count = _elements->input.size();
+    int count = _elements->input.size();
 
+    // PQexecPrepared takes null arrays for a statement without parameters
+    if ( count )
         str <<
             "const char *paramValues[" << count << "];\n"
             "int paramLengths[" << count << "];\n"
             "int paramFormats[" << count <<  "];";
+    else
+        str <<
+            "const char * const *paramValues = NULL;\n"
+            "const int *paramLengths = NULL;\n"
+            "const int *paramFormats = NULL;";
 
-        buffDict->SetValue(tpl_BUFFER_ALLOC, str.str() );
-    }
-}
+    buffDict->SetValue(tpl_BUFFER_ALLOC, str.str() );
 
-void PostgreSQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictionary *_subDict, const AbstractElements* _elements)
-{
-    TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS_BUFFERS);
-    
+    // Network order copies of the parameters, one member per parameter
     std::stringstream decl, init;
-    
-    decl << "int m_rowNum;\nint m_rowCount;";
-    init << "m_rowNum = -1;\nm_rowCount = -1;";
-    
+
     ListElements::const_iterator it = _elements->input.begin(), end = _elements->input.end();
     for(; it != end; it++)
     {
+        // The encoded array, reused across calls
+        if (it->list)
+        {
+            decl << "std::string m_buff" << it->name << ";\n";
+            continue;
+        }
+
         switch(it->type)
         {
             case stInt:
@@ -504,10 +832,24 @@ void PostgreSQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDic
                 break;
             }
 
+            case stBool:
+                decl << "char m_buff" << it->name << ";\n";
+                init << "m_buff" << it->name << " = 0;\n";
+                break;
+
             case stTimeStamp:
             case stTime:
+                decl << "int64_t m_buff" << it->name << ";\n";
+                init << "m_buff" << it->name << " = 0;\n";
+                break;
+
             case stDate:
-                FATAL(__FILE__  << ':' << __LINE__ << ": Invalid param type: '" << it->name << "': " << it->type);
+                decl << "int32_t m_buff" << it->name << ";\n";
+                init << "m_buff" << it->name << " = 0;\n";
+                break;
+
+            case stDecimal:
+                decl << "char m_buff" << it->name << "[DBBinderDecimal::STRING_SIZE];\n";
                 break;
 
             case stText:
@@ -524,4 +866,17 @@ void PostgreSQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDic
     buffDict->SetValue(tpl_BUFFER_INITIALIZE, init.str());
 }
 
+void PostgreSQLGenerator::addOutBuffers(SQLStatementTypes /*_type*/, TemplateDictionary *_subDict, const AbstractElements* /*_elements*/)
+{
+    TemplateDictionary *buffDict = _subDict->AddSectionDictionary(tpl_STMT_OUT_FIELDS_BUFFERS);
+    
+    std::stringstream decl, init;
+    
+    decl << "int m_rowNum;\nint m_rowCount;";
+    init << "m_rowNum = -1;\nm_rowCount = -1;";
+    
+    buffDict->SetValue(tpl_BUFFER_DECLARE, decl.str());
+    buffDict->SetValue(tpl_BUFFER_INITIALIZE, init.str());
+}
+
 }
@@ -35,15 +35,26 @@ public:
     virtual ~PostgreSQLGenerator();
 
     virtual void addSelect(SelectElements _elements);
+    virtual void addUpdate(UpdateElements _elements) __C11_OVERRIDE;
+    virtual void addInsert(InsertElements _elements) __C11_OVERRIDE;
+    virtual void addDelete(DeleteElements _elements) __C11_OVERRIDE;
 
 private:
     PGconn      *m_conn;
 
+    void explain(const AbstractElements& _elements);
+
 protected:
     virtual bool checkConnection() __C11_OVERRIDE;
     virtual std::string getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamLength(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamRead(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                     const ListString& _keys, const ListString& _updates) __C11_OVERRIDE;
+    virtual std::string getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                   const std::vector<int>& _params, const ListElements& _input) __C11_OVERRIDE;
 
     virtual bool needIOBuffers() const __C11_OVERRIDE;
 
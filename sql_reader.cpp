@@ -203,6 +203,7 @@ void parseSQL(const std::string& _fileName)
         SQLTypes type;
         std::string name, defaultValue, strType;
         int index;
+        bool list;
 
         // Load all other params now that we got a generator
         while ( file.good() )
@@ -232,6 +233,20 @@ void parseSQL(const std::string& _fileName)
                             static_cast<SelectElements*>( elements )->keyFieldName = params.front();
                         }
                         break;
+                    case 'l':
+                        if (tokens[1] == "lazy")
+                        {
+                            if (tokens.size() > 2)
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing lazy param for non-select statement");
+                            }
+                            else
+                                static_cast<SelectElements*>( elements )->lazy = true;
+                        }
+                        break;
                     case 'n':
                         if (tokens[1] == "name")
                         {
@@ -247,7 +262,53 @@ void parseSQL(const std::string& _fileName)
                         }
                         break;
                     case 'p':
-                        if (tokens[1] == "param")
+                        if (tokens[1] == "paginate")
+                        {
+                            ListString params(tokens.begin() + 2, tokens.end());
+
+                            if ( params.size() < 2 )
+                                FATAL(fileName << ':' << line << ": paginate needs a key field and a page size");
+
+                            if ( params.size() > 2 )
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing paginate param for non-select statement");
+                            }
+                            else
+                            {
+                                SelectElements *select = static_cast<SelectElements*>( elements );
+                                select->keyFieldName = params.at(0);
+                                select->pageSize = atoi( params.at(1).c_str() );
+
+                                if ( select->pageSize < 1 )
+                                    FATAL(fileName << ':' << line << ": page size must be a positive number");
+                            }
+                        }
+                        else if (tokens[1] == "partition")
+                        {
+                            ListString params(tokens.begin() + 2, tokens.end());
+
+                            if ( params.size() < 3 )
+                                FATAL(fileName << ':' << line << ": partition needs a key field and its low and high bound params");
+
+                            if ( params.size() > 3 )
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing partition param for non-select statement");
+                            }
+                            else
+                            {
+                                SelectElements *select = static_cast<SelectElements*>( elements );
+                                select->keyFieldName = params.at(0);
+                                select->partitionLow = params.at(1);
+                                select->partitionHigh = params.at(2);
+                            }
+                        }
+                        else if (tokens[1] == "param")
                         {
                             ListString params(tokens.begin() + 2, tokens.end());
 
@@ -261,6 +322,7 @@ void parseSQL(const std::string& _fileName)
                             defaultValue.clear();
                             index = -1;
                             type = stUnknown;
+                            list = false;
 
                             int i = 0;
                             for(ListString::const_iterator it = params.begin(); it != params.end(); it++, i++)
@@ -268,7 +330,7 @@ void parseSQL(const std::string& _fileName)
                                 switch( i )
                                 {
                                     case 0: name = *it; break;
-                                    case 1: type = typeNameToSQLType(*it); break;
+                                    case 1: type = typeNameToSQLType(*it, list); break;
                                     case 2: defaultValue = *it; break;
                                     case 3: index = atoi( it->c_str() ); break;
                                 }
@@ -278,6 +340,108 @@ void parseSQL(const std::string& _fileName)
                                 FATAL(fileName << ':' << line << ": illegal param type");
 
                             elements->input.push_back( SQLElement( name, type, index, defaultValue ));
+                            elements->input.back().list = list;
+                        }
+                        break;
+                    case 'r':
+                        if (tokens[1] == "result")
+                        {
+                            ListString params(tokens.begin() + 2, tokens.end());
+
+                            if ( params.size() == 0 )
+                                FATAL(fileName << ':' << line << ": missing result mode argument");
+
+                            if ( params.size() > 2 )
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing result param for non-select statement");
+                            }
+                            else
+                            {
+                                SelectElements *select = static_cast<SelectElements*>( elements );
+                                const std::string &mode = params.front();
+
+                                if (mode == "stream")
+                                    select->resultMode = srmStream;
+                                else if (mode == "store")
+                                    select->resultMode = srmStore;
+                                else if (mode == "cursor")
+                                    select->resultMode = srmCursor;
+                                else
+                                    FATAL(fileName << ':' << line << ": illegal result mode '" << mode << "', expected stream, store or cursor");
+
+                                if ( params.size() > 1 )
+                                {
+                                    if (select->resultMode != srmCursor)
+                                        WARNING(fileName << ':' << line << ": ignoreing prefetch rows for a non-cursor result");
+
+                                    select->prefetchRows = atoi( params.at(1).c_str() );
+                                    if ( select->prefetchRows < 1 )
+                                        FATAL(fileName << ':' << line << ": prefetch rows must be a positive number");
+                                }
+                            }
+                        }
+                        break;
+                    case 's':
+                        if (tokens[1] == "stream")
+                        {
+                            ListString params(tokens.begin() + 2, tokens.end());
+
+                            if ( params.size() == 0 )
+                                FATAL(fileName << ':' << line << ": missing stream field argument");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing stream param for non-select statement");
+                            }
+                            else
+                            {
+                                SelectElements *select = static_cast<SelectElements*>( elements );
+                                select->streamFieldNames.insert(select->streamFieldNames.end(), params.begin(), params.end());
+                            }
+                        }
+                        else if (tokens[1] == "single" || tokens[1] == "scalar")
+                        {
+                            if (tokens.size() > 2)
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            if (statementType != sstSelect)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing " << tokens[1] << " param for non-select statement");
+                            }
+                            else if (tokens[1] == "single")
+                                static_cast<SelectElements*>( elements )->single = true;
+                            else
+                                static_cast<SelectElements*>( elements )->scalar = true;
+                        }
+                        else if (tokens[1] == "scan")
+                        {
+                            if (tokens.size() > 2)
+                                WARNING(fileName << ':' << line << ": ignoreing extra params");
+
+                            elements->allowScan = true;
+                        }
+                        break;
+                    case 'u':
+                        if (tokens[1] == "upsert")
+                        {
+                            ListString params(tokens.begin() + 2, tokens.end());
+
+                            if ( params.size() == 0 )
+                                FATAL(fileName << ':' << line << ": missing upsert key argument");
+
+                            if (statementType != sstInsert && statementType != sstUpsert)
+                            {
+                                WARNING(fileName << ':' << line << ": ignoreing upsert param for non-insert statement");
+                            }
+                            else
+                            {
+                                InsertElements *insert = static_cast<InsertElements*>( elements );
+                                insert->conflictKeys.insert(insert->conflictKeys.end(), params.begin(), params.end());
+                                insert->type = statementType = sstUpsert;
+                            }
                         }
                         break;
                 }
@@ -292,6 +456,9 @@ void parseSQL(const std::string& _fileName)
             case sstInsert:
                 generator->addInsert( *static_cast<InsertElements*>( elements ));
                 break;
+            case sstUpsert:
+                generator->addUpsert( *static_cast<InsertElements*>( elements ));
+                break;
             case sstUpdate:
                 generator->addUpdate( *static_cast<UpdateElements*>( elements ));
                 break;
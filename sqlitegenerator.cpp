@@ -19,6 +19,8 @@
 
 #include "sqlitegenerator.h"
 
+#include <fstream>
+
 #define SQLFATAL(STR) FATAL( "SQLite3: " << STR << sqlite3_errmsg(m_db) )
 #define SQLCHECK(STR) { if ( ret != SQLITE_OK ) FATAL( STR << sqlite3_errmsg(m_db) ); }
 
@@ -26,7 +28,8 @@ namespace DBBinder
 {
 
 SQLiteGenerator::SQLiteGenerator(): AbstractGenerator(),
-        m_db( 0 )
+        m_db( 0 ),
+        m_openFlags( "SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE" )
 {
     m_dbengine = "sqlite3";
 
@@ -39,8 +42,42 @@ SQLiteGenerator::~SQLiteGenerator()
         sqlite3_close( m_db );
 }
 
+std::string SQLiteGenerator::dbParamPath( const std::string& _path ) const
+{
+    if ( _path[0] == '/' || m_dbParamRootDir.empty() )
+        return _path;
+
+    return m_dbParamRootDir + '/' + _path;
+}
+
 bool SQLiteGenerator::checkConnection()
 {
+    // With a 'schema' (a DDL script) the statements are described by an
+    // in-memory copy of the database, the real one isn't needed
+    _dbParams::iterator it = m_dbParams.find( "schema" );
+    if ( !m_connected && it != m_dbParams.end() )
+    {
+        const std::string& schemaFile = it->second.value;
+
+        if ( schemaFile.empty() )
+            FATAL( "SQLite3: 'schema' db parameter is empty." );
+
+        std::ifstream file( dbParamPath( schemaFile ).c_str() );
+        if ( !file )
+            FATAL( "SQLite3: can't read schema '" << dbParamPath( schemaFile ) << "'." );
+
+        std::stringstream schema;
+        schema << file.rdbuf();
+
+        if ( sqlite3_open( ":memory:", &m_db ) != SQLITE_OK )
+            SQLFATAL( "Can't open in-memory database: " );
+
+        if ( sqlite3_exec( m_db, schema.str().c_str(), 0, 0, 0 ) != SQLITE_OK )
+            SQLFATAL( schemaFile << ": " );
+
+        m_connected = true;
+    }
+
     if ( !m_connected )
     {
         std::string dbName = m_dbParams["file"].value;
@@ -48,12 +85,7 @@ bool SQLiteGenerator::checkConnection()
         if ( dbName.empty() || dbName.length() < 1 )
             FATAL( "SQLite3: 'file' db parameter is empty." );
 
-        if ( dbName[0] != '/' )
-        {
-            std::string root = m_dbParamRootDir;
-            root += '/';
-            dbName =  root + dbName;
-        }
+        dbName = dbParamPath( dbName );
 
         int ret = sqlite3_open( dbName.c_str(), &m_db );
 
@@ -69,6 +101,121 @@ bool SQLiteGenerator::checkConnection()
     return m_connected;
 }
 
+static bool isSQLiteNumber( const std::string& _value )
+{
+    std::string::size_type i = ( !_value.empty() && _value[0] == '-' ) ? 1 : 0;
+
+    if ( i == _value.length() )
+        return false;
+
+    for ( ; i < _value.length(); ++i )
+        if ( !isdigit( _value[i] ) )
+            return false;
+
+    return true;
+}
+
+static bool isSQLiteKeyword( const std::string& _value )
+{
+    if ( _value.empty() )
+        return false;
+
+    for ( std::string::size_type i = 0; i < _value.length(); ++i )
+        if ( !isalnum( _value[i] ) )
+            return false;
+
+    return true;
+}
+
+void SQLiteGenerator::loadDatabase()
+{
+    // These are not connection parameters: take them out of m_dbParams so they
+    // don't become Connection constructor arguments.
+    _dbParams::iterator it = m_dbParams.find( "flags" );
+    if ( it != m_dbParams.end() )
+    {
+        static const char * const FLAGS[] = { "readonly", "readwrite", "create", "uri", "memory",
+                                              "nomutex", "fullmutex", "sharedcache", "privatecache", 0 };
+
+        const std::string& flags = it->second.value;
+        std::string::size_type start = 0, end;
+
+        m_openFlags.clear();
+        do
+        {
+            end = flags.find_first_of( "|, ", start );
+            std::string flag = stringToLower( flags.substr( start, end == std::string::npos ? end : end - start ));
+            start = end + 1;
+
+            if ( flag.empty() )
+                continue;
+
+            int i = 0;
+            while ( FLAGS[i] && flag != FLAGS[i] )
+                ++i;
+
+            if ( !FLAGS[i] )
+                FATAL( "SQLite3: unknown open flag '" << flag << "'." );
+
+            if ( !m_openFlags.empty() )
+                m_openFlags += " | ";
+            m_openFlags += "SQLITE_OPEN_" + stringToUpper( flag );
+        }
+        while ( end != std::string::npos );
+
+        if ( m_openFlags.empty() )
+            FATAL( "SQLite3: 'flags' db parameter is empty." );
+
+        m_dbParams.erase( it );
+    }
+
+    // Only used while generating, see checkConnection()
+    it = m_dbParams.find( "schema" );
+    if ( it != m_dbParams.end() )
+        m_dbParams.erase( it );
+
+    // busy_timeout goes first, switching journal_mode may have to wait for a lock
+    static const char * const PRAGMAS[] = { "busy_timeout", "journal_mode", "synchronous", "mmap_size", "cache_size", 0 };
+    static const bool PRAGMA_IS_NUMBER[] = { true, false, false, true, true };
+
+    m_pragmas.clear();
+    for ( int i = 0; PRAGMAS[i]; ++i )
+    {
+        it = m_dbParams.find( PRAGMAS[i] );
+        if ( it == m_dbParams.end() )
+            continue;
+
+        const std::string& value = it->second.value;
+        if ( PRAGMA_IS_NUMBER[i] ? !isSQLiteNumber( value ) : !isSQLiteKeyword( value ))
+            FATAL( "SQLite3: invalid value '" << value << "' for '" << PRAGMAS[i] << "'." );
+
+        m_pragmas += std::string( "PRAGMA " ) + PRAGMAS[i] + " = " + value + ";";
+        m_dbParams.erase( it );
+    }
+
+    AbstractGenerator::loadDatabase();
+}
+
+std::string SQLiteGenerator::parseStringVariables( std::string str )
+{
+    static const char * const VARIABLES[] = { "%SQLITE_OPEN_FLAGS%", "%SQLITE_PRAGMAS%", 0 };
+    const std::string * const values[] = { &m_openFlags, &m_pragmas };
+
+    for ( int i = 0; VARIABLES[i]; ++i )
+    {
+        const std::string::size_type len = strlen( VARIABLES[i] );
+        std::string::size_type pos = 0;
+
+        while (( pos = str.find( VARIABLES[i], pos )) != std::string::npos )
+        {
+            str.replace( pos, len, *values[i] );
+            pos += values[i]->length();
+        }
+    }
+
+    return AbstractGenerator::parseStringVariables( str );
+}
+
 std::string SQLiteGenerator::getBind( SQLStatementTypes _type, const ListElements::iterator & _item, int _index )
 {
     // TODO Abstract this
@@ -86,9 +233,19 @@ std::string SQLiteGenerator::getBind( SQLStatementTypes _type, const ListElement
             FATAL("Uknown type!");
     }
 
+    if ( _item->list )
+    {
+        // One JSON array text, the statement reads it with json_each(?)
+        std::stringstream list;
+        list << "{ std::string buff; dbbinderJSONArray(buff, _" << _item->name << "); " << str.str() << "text(m_" << typeName << "Stmt, "
+             << _index + 1 << ", buff.data(), buff.size(), SQLITE_TRANSIENT )); }";
+        return list.str();
+    }
+
     switch ( _item->type )
     {
         case stUnknown:
+        case stEnum:    // SQLite has no enum columns
         {
             FATAL( "BUG BUG BUG! " << __FILE__ << __LINE__ );
         }
@@ -97,6 +254,7 @@ std::string SQLiteGenerator::getBind( SQLStatementTypes _type, const ListElement
         case stUInt:
         case stInt64:
         case stUInt64:
+        case stBool:
         {
             str << "int";
             break;
@@ -111,9 +269,28 @@ std::string SQLiteGenerator::getBind( SQLStatementTypes _type, const ListElement
             break;
         }
 
+        case stDecimal:
+        {
+            // Formatted on the stack, so SQLite has to take a copy
+            std::stringstream dec;
+            dec << "{ char buff[DBBinderDecimal::STRING_SIZE]; " << str.str() << "text(m_" << typeName << "Stmt, "
+                << _index + 1 << ", _" << _item->name << ".format(buff), -1, SQLITE_TRANSIENT )); }";
+            return dec.str();
+        }
+
         case stTimeStamp:
         case stTime:
         case stDate:
+        {
+            // Stored as ISO text, so the SQLite date functions keep working on the column
+            std::stringstream time;
+            time << "{ char buff[SQLITE_TIME_SIZE]; if ( dbbinderTimeIsNull(_" << _item->name << ") ) SQLCHECK( sqlite3_bind_null(m_"
+                 << typeName << "Stmt, " << _index + 1 << " )); else " << str.str() << "text(m_" << typeName << "Stmt, " << _index + 1
+                 << ", sqliteFormatMicros(dbbinderToMicros(_" << _item->name << "), buff, " << ( _item->type != stTime ? "true" : "false" )
+                 << ", " << ( _item->type != stDate ? "true" : "false" ) << "), -1, SQLITE_TRANSIENT )); }";
+            return time.str();
+        }
+
         case stText:
         case stBlob:
         {
@@ -161,6 +338,7 @@ std::string SQLiteGenerator::getReadValue( SQLStatementTypes _type, const ListEl
     switch ( _item->type )
     {
         case stUnknown:
+        case stEnum:    // SQLite has no enum columns
         {
             FATAL( "BUG BUG BUG! " << __FILE__ << __LINE__ );
         }
@@ -174,6 +352,12 @@ std::string SQLiteGenerator::getReadValue( SQLStatementTypes _type, const ListEl
             break;
         }
 
+        case stBool:
+        {
+            str << "m_" << _item->name << " = sqlite3_column_int(_parent->m_" << typeName << "Stmt, " << _index << ") != 0;";
+            break;
+        }
+
         case stFloat:
         case stUFloat:
         case stDouble:
@@ -183,9 +367,20 @@ std::string SQLiteGenerator::getReadValue( SQLStatementTypes _type, const ListEl
             break;
         }
 
+        case stDecimal:
+        {
+            str << "m_" << _item->name << " = DBBinderDecimal::parse( reinterpret_cast<const char*>( sqlite3_column_text(_parent->m_" << typeName << "Stmt, " << _index << ") ) );";
+            break;
+        }
+
         case stTimeStamp:
         case stTime:
         case stDate:
+        {
+            str << "dbbinderFromMicros(sqliteColumnMicros(_parent->m_" << typeName << "Stmt, " << _index << "), m_" << _item->name << ");";
+            break;
+        }
+
         case stText:
         case stBlob:
         {
@@ -202,7 +397,103 @@ std::string SQLiteGenerator::getIsNull(SQLStatementTypes /*_type*/, const ListEl
     // TODO Abstract this
     std::stringstream str;
 
-    str << "( sqlite3_column_type( _parent->m_selectStmt, " << _index << " ) == SQLITE_NULL );";
+    str << "( sqlite3_column_type( _parent->m_selectStmt, " << _index << " ) == SQLITE_NULL )";
+
+    return str.str();
+}
+
+std::string SQLiteGenerator::getStreamLength(const ListElements::iterator& _item, int _index)
+{
+    if ( _item->sourceTable.empty() )
+        return std::string();
+
+    std::stringstream str;
+
+    str << "if ( sqlite3_column_type( m_selectStmt, " << _index << " ) == SQLITE_NULL )\n"
+        << "    return 0;\n"
+        << "size_t size = 0;\n"
+        << "SQLCHECK( sqliteBlobRead( m_conn, \"" << _item->sourceSchema << "\", \"" << _item->sourceTable << "\", \"" << _item->sourceColumn << "\",\n"
+        << "                          sqlite3_column_int64( m_selectStmt, " << _index << " ), NULL, 0, 0, size ));\n"
+        << "return size;";
+
+    return str.str();
+}
+
+std::string SQLiteGenerator::getStreamRead(const ListElements::iterator& _item, int _index)
+{
+    // The select has the rowid of the value in its place (setStreamSources),
+    // so it is read in pieces with incremental blob I/O
+    if ( _item->sourceTable.empty() )
+        return std::string();
+
+    std::stringstream str;
+
+    str << "if ( sqlite3_column_type( m_selectStmt, " << _index << " ) == SQLITE_NULL )\n"
+        << "    return 0;\n"
+        << "size_t count = 0;\n"
+        << "SQLCHECK( sqliteBlobRead( m_conn, \"" << _item->sourceSchema << "\", \"" << _item->sourceTable << "\", \"" << _item->sourceColumn << "\",\n"
+        << "                          sqlite3_column_int64( m_selectStmt, " << _index << " ), _buffer, _length, _offset, count ));\n"
+        << "return count;";
+
+    return str.str();
+}
+
+std::string SQLiteGenerator::getUpsertSQL( const std::string& _table, const ListString& _columns, const ListString& _values,
+                                           const ListString& _keys, const ListString& _updates )
+{
+    // ON CONFLICT needs SQLite 3.24, and a unique index or primary key on exactly _keys
+    std::stringstream str;
+
+    str << "INSERT INTO " << _table << " (" << stringJoin( _columns, ", " ) << ")\n"
+        << "VALUES (" << stringJoin( _values, ", " ) << ")\n"
+        << "ON CONFLICT (" << stringJoin( _keys, ", " ) << ") DO ";
+
+    if ( _updates.empty() )
+        str << "NOTHING";
+    else
+    {
+        str << "UPDATE SET ";
+        for ( ListString::const_iterator it = _updates.begin(); it != _updates.end(); ++it )
+            str << ( it == _updates.begin() ? "" : ", " ) << *it << " = excluded." << *it;
+    }
+
+    return str.str();
+}
+
+std::string SQLiteGenerator::getManySQL( const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                         const std::vector<int>& _params, const ListElements& _input )
+{
+    // Each list is a JSON array, json_each() rows of the same key are one
+    // element; UPDATE ... FROM needs SQLite 3.33
+    std::stringstream rows, str;
+
+    rows << "(SELECT ";
+    for ( size_t i = 1; i <= _input.size(); ++i )
+        rows << ( i > 1 ? ", " : "" ) << "dbbinder_j" << i << ".value AS dbbinder_p" << i;
+    rows << " FROM ";
+    for ( size_t i = 1; i <= _input.size(); ++i )
+        rows << ( i > 1 ? ", " : "" ) << "json_each(?" << i << ") AS dbbinder_j" << i;
+    for ( size_t i = 2; i <= _input.size(); ++i )
+        rows << ( i > 2 ? " AND " : " WHERE " ) << "dbbinder_j" << i << ".key = dbbinder_j1.key";
+    rows << ")";
+
+    std::vector<int>::const_iterator param = _params.begin();
+    if ( _columns.empty() )
+    {
+        str << "DELETE FROM " << _table << "\nWHERE (" << stringJoin( _keys, ", " ) << ") IN (SELECT ";
+        for ( ; param != _params.end(); ++param )
+            str << ( param == _params.begin() ? "" : ", " ) << "dbbinder_p" << *param + 1;
+        str << " FROM " << rows.str() << ")";
+        return str.str();
+    }
+
+    str << "UPDATE " << _table << " SET ";
+    for ( ListString::const_iterator it = _columns.begin(); it != _columns.end(); ++it, ++param )
+        str << ( it == _columns.begin() ? "" : ", " ) << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
+
+    str << "\nFROM " << rows.str() << " AS dbbinder_rows\nWHERE ";
+    for ( ListString::const_iterator it = _keys.begin(); it != _keys.end(); ++it, ++param )
+        str << ( it == _keys.begin() ? "" : " AND " ) << *it << " = dbbinder_rows.dbbinder_p" << *param + 1;
 
     return str.str();
 }
@@ -263,9 +554,44 @@ sqlite3_stmt *SQLiteGenerator::execSQL( AbstractElements &_elements )
         FATAL( _elements.sql_location.file << ':' << line << ':' << col << ": error " << sqlite3_errmsg( m_db ) );
     }
 
+    if ( !optPlanCheck.empty() )
+        explain( _elements );
+
     return stmt;
 }
 
+void SQLiteGenerator::explain( const AbstractElements &_elements )
+{
+    std::string sql = "EXPLAIN QUERY PLAN " + _elements.sql;
+    sqlite3_stmt *stmt = 0;
+
+    if ( sqlite3_prepare( m_db, sql.c_str(), sql.length(), &stmt, 0 ) != SQLITE_OK )
+        SQLFATAL( _elements.sql_location.file << ": EXPLAIN QUERY PLAN: " );
+
+    std::string plan;
+    ListString scans;
+    std::map<int, int> depth;
+
+    // Rows are id, parent, notused, detail; the parent gives the nesting
+    while ( sqlite3_step( stmt ) == SQLITE_ROW )
+    {
+        int level = depth[ sqlite3_column_int( stmt, 0 ) ] = depth[ sqlite3_column_int( stmt, 1 ) ] + 1;
+        std::string detail = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 3 ) );
+
+        plan += std::string( level * 2 - 2, ' ' ) + detail + '\n';
+
+        // "SCAN t" ("SCAN TABLE t" before 3.36); walking an index, a constant
+        // row or an already materialized subquery is fine
+        if ( detail.compare( 0, 5, "SCAN " ) == 0 && detail.find( "INDEX" ) == std::string::npos &&
+             detail.find( "CONSTANT ROW" ) == std::string::npos && stringToLower( detail ).find( "subquery" ) == std::string::npos )
+            scans.push_back( detail );
+    }
+
+    sqlite3_finalize( stmt );
+
+    checkQueryPlan( _elements, plan, scans );
+}
+
 void SQLiteGenerator::addSelect( SelectElements _elements )
 {
     sqlite3_stmt *stmt = execSQL( _elements );
@@ -286,6 +612,7 @@ void SQLiteGenerator::addSelect( SelectElements _elements )
     int count = sqlite3_column_count( stmt );
 
     const char* typeStr;
+    std::string declType;
     SQLTypes type;
     std::string name;
 
@@ -296,6 +623,10 @@ void SQLiteGenerator::addSelect( SelectElements _elements )
 
         if ( typeStr )
         {
+            // Declared types are kept as written: INTEGER, Boolean...
+            declType = stringToLower( typeStr );
+            typeStr = declType.c_str();
+
             switch ( *typeStr )
             {
                 case 'i': // Integer
@@ -304,8 +635,30 @@ void SQLiteGenerator::addSelect( SelectElements _elements )
                 case 'f': // Float
                     type = stFloat;
                     break;
-                case 'b': // blob
-                case 't': // text
+                case 'd': // decimal, date and datetime
+                    if ( strncmp( typeStr, "dec", 3 ) == 0 )
+                        type = stDecimal;
+                    else if ( strncmp( typeStr, "datetime", 8 ) == 0 )
+                        type = stTimeStamp;
+                    else if ( strncmp( typeStr, "date", 4 ) == 0 )
+                        type = stDate;
+                    else
+                        type = stText;
+                    break;
+                case 'n': // numeric
+                    type = stDecimal;
+                    break;
+                case 't': // timestamp, time and text
+                    if ( strncmp( typeStr, "timestamp", 9 ) == 0 )
+                        type = stTimeStamp;
+                    else if ( strncmp( typeStr, "time", 4 ) == 0 )
+                        type = stTime;
+                    else
+                        type = stText;
+                    break;
+                case 'b': // bool, boolean and blob
+                    type = strncmp( typeStr, "bool", 4 ) == 0 ? stBool : stText;
+                    break;
                 default:
                     type = stText;
             };
@@ -313,14 +666,261 @@ void SQLiteGenerator::addSelect( SelectElements _elements )
         else
             type = stText;
 
+        // decimal(p, s): SQLite doesn't check it, but it is what the column holds
+        if ( type == stDecimal && strchr( typeStr, '(' ) && atoi( strchr( typeStr, '(' ) + 1 ) > DECIMAL_MAX_PRECISION )
+            FATAL( _elements.name << ": decimal field '" << name << "' has " << atoi( strchr( typeStr, '(' ) + 1 ) << " digits, more than the "
+                   << DECIMAL_MAX_PRECISION << " a DBBinderDecimal holds" );
+
         _elements.output.push_back( SQLElement( name, type, i ) );
     }
 
+    setStreamSources( _elements, stmt );
     sqlite3_finalize( stmt );
 
     AbstractGenerator::addSelect( _elements );
 }
 
+// Splits the select list of a plain "select ... from" at its top level
+// commas; false for anything else (with, values, distinct, compound selects)
+static bool selectListItems( const std::string& _sql, std::vector< std::pair<size_t, size_t> >& _items )
+{
+    size_t pos = 0, size = _sql.size(), start = std::string::npos;
+    int depth = 0;
+    bool inList = false, first = false;
+
+    while ( pos < size )
+    {
+        char c = _sql[pos];
+
+        if ( c == '\'' || c == '"' || c == '`' || c == '[' )
+        {
+            char close = c == '[' ? ']' : c;
+            pos = _sql.find( close, pos + 1 );
+            if ( pos == std::string::npos )
+                return false;
+            ++pos;
+        }
+        else if ( c == '-' && _sql.compare( pos, 2, "--" ) == 0 )
+            pos = _sql.find( '\n', pos );
+        else if ( c == '/' && _sql.compare( pos, 2, "/*" ) == 0 )
+        {
+            pos = _sql.find( "*/", pos );
+            if ( pos != std::string::npos )
+                pos += 2;
+        }
+        else if ( c == '(' )
+            ++depth, ++pos;
+        else if ( c == ')' )
+            --depth, ++pos;
+        else if ( isalpha( static_cast<unsigned char>( c )) || c == '_' )
+        {
+            size_t end = pos;
+            while ( end < size && ( isalnum( static_cast<unsigned char>( _sql[end] )) || _sql[end] == '_' ))
+                ++end;
+
+            std::string word = stringToLower( _sql.substr( pos, end - pos ));
+
+            if ( depth == 0 )
+            {
+                if ( start == std::string::npos )
+                {
+                    if ( word != "select" )
+                        return false;
+                    inList = first = true;
+                    start = end;
+                    pos = end;
+                    continue;
+                }
+                else if ( first && ( word == "distinct" || word == "all" ))
+                    return false;
+                else if ( inList && word == "from" )
+                {
+                    _items.push_back( std::make_pair( start, pos ));
+                    inList = false;
+                }
+                else if ( word == "union" || word == "intersect" || word == "except" )
+                    return false;
+            }
+            first = false;
+            pos = end;
+        }
+        else
+        {
+            if ( !isspace( static_cast<unsigned char>( c )))
+                first = false;
+            if ( c == ',' && depth == 0 && inList )
+            {
+                _items.push_back( std::make_pair( start, pos ));
+                start = pos + 1;
+            }
+            ++pos;
+        }
+    }
+
+    return !inList && !_items.empty();
+}
+
+// Reads a plain or quoted identifier at _pos, after any blanks
+static bool readIdentifier( const std::string& _sql, size_t& _pos, size_t _end, std::string& _name )
+{
+    while ( _pos < _end && isspace( static_cast<unsigned char>( _sql[_pos] )))
+        ++_pos;
+
+    if ( _pos >= _end )
+        return false;
+
+    char c = _sql[_pos];
+    if ( c == '"' || c == '`' || c == '[' )
+    {
+        size_t close = _sql.find( c == '[' ? ']' : c, _pos + 1 );
+        if ( close == std::string::npos || close >= _end )
+            return false;
+
+        _name = _sql.substr( _pos + 1, close - _pos - 1 );
+        _pos = close + 1;
+        return true;
+    }
+
+    size_t start = _pos;
+    while ( _pos < _end && ( isalnum( static_cast<unsigned char>( _sql[_pos] )) || _sql[_pos] == '_' ))
+        ++_pos;
+
+    _name = _sql.substr( start, _pos - start );
+    return !_name.empty();
+}
+
+void SQLiteGenerator::setStreamSources( SelectElements& _elements, sqlite3_stmt* _stmt )
+{
+    if ( _elements.streamFieldNames.empty() )
+        return;
+
+    // Selecting a blob makes sqlite3_step() load all of it, so a streamed
+    // column is replaced in the select list by the rowid of its row, and
+    // read later through sqlite3_blob_open()
+    std::vector< std::pair<size_t, size_t> > items;
+    if ( !selectListItems( _elements.sql, items ) || items.size() != _elements.output.size() )
+    {
+        WARNING( _elements.name << ": can't find the select list, streamed fields will be read whole" );
+        return;
+    }
+
+    std::string sql = _elements.sql, check = _elements.sql;
+    std::vector<ListElements::iterator> streamed;
+    int index = static_cast<int>( items.size() ) - 1;
+
+    for ( ListElements::iterator it = --_elements.output.end(); index >= 0; --it, --index )
+    {
+        bool stream = false;
+        for ( ListString::const_iterator field = _elements.streamFieldNames.begin(); field != _elements.streamFieldNames.end(); ++field )
+            stream = stream || strcasecmp( it->name.c_str(), field->c_str() ) == 0;
+
+        if ( !stream || ( it->type != stText && it->type != stBlob ))
+            continue;
+
+        const char *schema = sqlite3_column_database_name( _stmt, index );
+        const char *table = sqlite3_column_table_name( _stmt, index );
+        const char *column = sqlite3_column_origin_name( _stmt, index );
+
+        // Only a plain column of a table, [qualifier.]column [[as] alias]
+        size_t begin = items[index].first, end = items[index].second, pos = begin;
+        std::string first, second, alias;
+        size_t qualifierEnd = std::string::npos;
+
+        bool plain = schema && table && column && readIdentifier( sql, pos, end, first );
+        size_t exprEnd = pos;
+
+        while ( plain && pos < end && isspace( static_cast<unsigned char>( sql[pos] )))
+            ++pos;
+
+        if ( plain && pos < end && sql[pos] == '.' )
+        {
+            qualifierEnd = exprEnd;
+            ++pos;
+            plain = readIdentifier( sql, pos, end, second );
+            exprEnd = pos;
+        }
+
+        if ( plain && readIdentifier( sql, pos, end, alias ) && strcasecmp( alias.c_str(), "as" ) == 0 )
+            plain = readIdentifier( sql, pos, end, alias );
+
+        while ( plain && pos < end && isspace( static_cast<unsigned char>( sql[pos] )))
+            ++pos;
+
+        plain = plain && pos == end && strcasecmp(( second.empty() ? first : second ).c_str(), column ) == 0;
+
+        if ( !plain )
+        {
+            WARNING( _elements.name << ": stream field '" << it->name << "' is not a table column, it will be read whole" );
+            continue;
+        }
+
+        while ( isspace( static_cast<unsigned char>( sql[begin] )))
+            ++begin;
+
+        std::string expr = sql.substr( begin, exprEnd - begin );
+        std::string rowid = qualifierEnd != std::string::npos ? sql.substr( begin, qualifierEnd - begin ) + ".rowid" : "rowid";
+        std::string name = it->name;
+
+        for ( size_t quote = name.find( '"' ); quote != std::string::npos; quote = name.find( '"', quote + 2 ))
+            name.insert( quote, 1, '"' );
+
+        sql.replace( items[index].first, items[index].second - items[index].first,
+                     " CASE WHEN typeof(" + expr + ") = 'null' THEN NULL ELSE " + rowid + " END AS \"" + name + "\" " );
+        check.replace( items[index].first, items[index].second - items[index].first, " " + rowid + " AS \"" + name + "\" " );
+
+        it->sourceSchema = schema;
+        it->sourceTable = table;
+        it->sourceColumn = column;
+        streamed.push_back( it );
+    }
+
+    if ( streamed.empty() )
+        return;
+
+    // The rowid has to come from the column's table: checked by preparing
+    // the select with the bare rowids, which fails on views and tables
+    // without rowid
+    sqlite3_stmt *stmt = 0;
+    const char *tail = 0;
+    int ret = sqlite3_prepare_v2( m_db, check.c_str(), check.size(), &stmt, &tail );
+    bool valid = ret == SQLITE_OK && stmt && sqlite3_column_count( stmt ) == static_cast<int>( _elements.output.size() );
+
+    for ( size_t i = 0; valid && i < streamed.size(); ++i )
+    {
+        int column = static_cast<int>( std::distance( _elements.output.begin(), streamed[i] ));
+        const char *schema = sqlite3_column_database_name( stmt, column );
+        const char *table = sqlite3_column_table_name( stmt, column );
+
+        valid = strcasecmp( sqlite3_column_name( stmt, column ), streamed[i]->name.c_str() ) == 0 &&
+                schema && strcasecmp( schema, streamed[i]->sourceSchema.c_str() ) == 0 &&
+                table && strcasecmp( table, streamed[i]->sourceTable.c_str() ) == 0;
+    }
+
+    sqlite3_finalize( stmt );
+    stmt = 0;
+
+    if ( valid )
+    {
+        valid = sqlite3_prepare_v2( m_db, sql.c_str(), sql.size(), &stmt, &tail ) == SQLITE_OK && stmt;
+        sqlite3_finalize( stmt );
+    }
+
+    if ( !valid )
+    {
+        WARNING( _elements.name << ": can't select the rowid of the streamed fields, they will be read whole" );
+
+        for ( size_t i = 0; i < streamed.size(); ++i )
+        {
+            streamed[i]->sourceSchema.clear();
+            streamed[i]->sourceTable.clear();
+            streamed[i]->sourceColumn.clear();
+        }
+        return;
+    }
+
+    _elements.sql = sql;
+}
+
 void SQLiteGenerator::addUpdate( UpdateElements _elements )
 {
     execSQL( _elements );
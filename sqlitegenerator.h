@@ -38,11 +38,28 @@ protected:
 
     sqlite3 *m_db;
 
+    // Connection options from the database section, applied in the generated Connection constructor
+    std::string m_openFlags;
+    std::string m_pragmas;
+
+    std::string dbParamPath(const std::string& _path) const;
+
+    virtual void loadDatabase() __C11_OVERRIDE;
+    virtual std::string parseStringVariables(std::string str) __C11_OVERRIDE;
+
     sqlite3_stmt *execSQL(AbstractElements &_elements);
+    void explain(const AbstractElements &_elements);
+    void setStreamSources(SelectElements &_elements, sqlite3_stmt *_stmt);
 
     virtual std::string getBind(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getReadValue(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
     virtual std::string getIsNull(SQLStatementTypes _type, const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamLength(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getStreamRead(const ListElements::iterator& _item, int _index) __C11_OVERRIDE;
+    virtual std::string getUpsertSQL(const std::string& _table, const ListString& _columns, const ListString& _values,
+                                     const ListString& _keys, const ListString& _updates) __C11_OVERRIDE;
+    virtual std::string getManySQL(const std::string& _table, const ListString& _columns, const ListString& _keys,
+                                   const std::vector<int>& _params, const ListElements& _input) __C11_OVERRIDE;
 public:
     virtual void addSelect(SelectElements _elements) __C11_OVERRIDE;
     virtual void addUpdate(UpdateElements _elements) __C11_OVERRIDE;
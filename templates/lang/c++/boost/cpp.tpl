@@ -26,22 +26,27 @@
 {{#SELECT}}
 const char * const {{CLASSNAME}}::s_selectSQL = {{STMT_SQL}};
 const int {{CLASSNAME}}::s_selectSQL_len = {{STMT_SQL_LEN}};
+const char * const {{CLASSNAME}}::s_selectName = {{STMT_PREPARED_NAME}};
 {{/SELECT}}
 {{#UPDATE}}
 const char * const {{CLASSNAME}}::s_updateSQL = {{STMT_SQL}};
 const int {{CLASSNAME}}::s_updateSQL_len = {{STMT_SQL_LEN}};
+const char * const {{CLASSNAME}}::s_updateName = {{STMT_PREPARED_NAME}};
 {{/UPDATE}}
 {{#INSERT}}
 const char * const {{CLASSNAME}}::s_insertSQL = {{STMT_SQL}};
 const int {{CLASSNAME}}::s_insertSQL_len = {{STMT_SQL_LEN}};
+const char * const {{CLASSNAME}}::s_insertName = {{STMT_PREPARED_NAME}};
 {{/INSERT}}
 {{#DELETE}}
 const char * const {{CLASSNAME}}::s_deleteSQL = {{STMT_SQL}};
 const int {{CLASSNAME}}::s_deleteSQL_len = {{STMT_SQL_LEN}};
+const char * const {{CLASSNAME}}::s_deleteName = {{STMT_PREPARED_NAME}};
 {{/DELETE}}
 {{#SPROC}}
 const char * const {{CLASSNAME}}::s_sprocSQL = {{STMT_SQL}};
 const int {{CLASSNAME}}::s_sprocSQL_len = {{STMT_SQL_LEN}};
+const char * const {{CLASSNAME}}::s_sprocName = {{STMT_PREPARED_NAME}};
 {{/SPROC}}
 
 {{CLASSNAME}}::{{CLASSNAME}}({{DBENGINE_CONNECTION_TYPE}} _conn):
@@ -52,6 +57,17 @@ const int {{CLASSNAME}}::s_sprocSQL_len = {{STMT_SQL_LEN}};
 {{#SELECT}}
         ,m_selectStmt({{DBENGINE_STATEMENT_NULL}})
         ,m_selectIsActive( false )
+{{#STMT_FETCH_ONE}}
+        ,m_selectIsReset( false )
+{{/STMT_FETCH_ONE}}
+{{#STMT_LAZY}}
+        ,m_fetchCount( 0 )
+        ,m_lazyRows( true )
+{{/STMT_LAZY}}
+{{#STMT_PAGINATE}}
+        ,m_pageNext( false )
+        ,m_pageDone( false )
+{{/STMT_PAGINATE}}
         ,m_iterator( NULL )
 {{/SELECT}}
 {{#UPDATE}}
@@ -121,41 +137,49 @@ const int {{CLASSNAME}}::s_sprocSQL_len = {{STMT_SQL_LEN}};
 
 {{CLASSNAME}}::~{{CLASSNAME}}()
 {
-    {{#SELECT}}
-    {{CLASSNAME}}::close();
-    {{/SELECT}}
+    // Never let an engine error escape a destructor
+    try
+    {
+        {{#SELECT}}
+        {{CLASSNAME}}::close();
+        {{/SELECT}}
 
-    {{#SPROC}}
-    {{CLASSNAME}}::close();
-    {{/SPROC}}
+        {{#SPROC}}
+        {{CLASSNAME}}::close();
+        {{/SPROC}}
     
-    {{#DBENGINE_TRANSACTION}}
-    {{#UPDATE}}{{DBENGINE_TRANSACTION_COMMIT}}{{/UPDATE}}
-    {{#INSERT}}{{DBENGINE_TRANSACTION_COMMIT}}{{/INSERT}}
-    {{#DELETE}}{{DBENGINE_TRANSACTION_COMMIT}}{{/DELETE}}
-    {{DBENGINE_TRANSACTION_COMMIT}}
-    {{/DBENGINE_TRANSACTION}}
+        {{#DBENGINE_TRANSACTION}}
+        {{#UPDATE}}{{DBENGINE_TRANSACTION_COMMIT}}{{/UPDATE}}
+        {{#INSERT}}{{DBENGINE_TRANSACTION_COMMIT}}{{/INSERT}}
+        {{#DELETE}}{{DBENGINE_TRANSACTION_COMMIT}}{{/DELETE}}
+        {{DBENGINE_TRANSACTION_COMMIT}}
+        {{/DBENGINE_TRANSACTION}}
 
-    {{#UPDATE}}
-    {{DBENGINE_DESTROY_UPDATE}}
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
-    {{/STMT_IN_FIELDS_BUFFERS}}
+        {{#UPDATE}}
+        {{DBENGINE_DESTROY_UPDATE}}
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
 
-    {{#STMT_OUT_FIELDS_BUFFERS}}{{BUFFER_FREE}}
-    {{/STMT_OUT_FIELDS_BUFFERS}}
-    {{/UPDATE}}
+        {{#STMT_OUT_FIELDS_BUFFERS}}{{BUFFER_FREE}}
+        {{/STMT_OUT_FIELDS_BUFFERS}}
+        {{/UPDATE}}
 
-    {{#INSERT}}
-    {{DBENGINE_DESTROY_INSERT}}
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
-    {{/STMT_IN_FIELDS_BUFFERS}}
-    {{/INSERT}}
+        {{#INSERT}}
+        {{DBENGINE_DESTROY_INSERT}}
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
+        {{/INSERT}}
 
-    {{#DELETE}}
-    {{DBENGINE_DESTROY_DELETE}}
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
-    {{/STMT_IN_FIELDS_BUFFERS}}
-    {{/DELETE}}
+        {{#DELETE}}
+        {{DBENGINE_DESTROY_DELETE}}
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_FREE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
+        {{/DELETE}}
+    }
+    catch (const DBBinder::Error& _error)
+    {
+        LOG_MSG(_error.what());
+    }
 }
 
 {{#SELECT}}
@@ -177,6 +201,17 @@ const int {{CLASSNAME}}::s_selectParamCount = {{STMT_PARAM_COUNT}};
 {{/DBENGINE_TRANSACTION}}
         m_selectStmt({{DBENGINE_STATEMENT_NULL}}),
         m_selectIsActive( false ),
+{{#STMT_FETCH_ONE}}
+        m_selectIsReset( false ),
+{{/STMT_FETCH_ONE}}
+{{#STMT_LAZY}}
+        m_fetchCount( 0 ),
+        m_lazyRows( true ),
+{{/STMT_LAZY}}
+{{#STMT_PAGINATE}}
+        m_pageNext( false ),
+        m_pageDone( false ),
+{{/STMT_PAGINATE}}
         m_iterator( NULL )
 {
     ASSERT_MSG(m_conn, "Connection must not be null!");
@@ -209,6 +244,10 @@ void {{CLASSNAME}}::open(
     {
         {{DBENGINE_RESET_SELECT}}
     }
+{{#STMT_LAZY}}
+    ++m_fetchCount;
+    m_lazyRows = true;
+{{/STMT_LAZY}}
 
     {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_ALLOC}}
     {{/STMT_IN_FIELDS_BUFFERS}}
@@ -222,13 +261,28 @@ void {{CLASSNAME}}::open(
     {{DBENGINE_EXECUTE_SELECT}}
 
     m_selectIsActive = true;
+{{#STMT_FETCH_ONE}}
+    m_selectIsReset = false;
+{{/STMT_FETCH_ONE}}
+{{#STMT_PAGINATE}}
+
+    {{#STMT_IN_FIELDS}}m_page{{STMT_IN_FIELD_NAME}} = _{{STMT_IN_FIELD_NAME}};
+    {{/STMT_IN_FIELDS}}m_pageNext = false;
+    m_pageDone = false;
+{{/STMT_PAGINATE}}
 }
 
 void {{CLASSNAME}}::close()
 {
-    if ( m_selectIsActive )
+    if ( m_selectIsActive{{#STMT_FETCH_ONE}} || m_selectIsReset{{/STMT_FETCH_ONE}} )
     {
         m_selectIsActive = false;
+{{#STMT_FETCH_ONE}}
+        m_selectIsReset = false;
+{{/STMT_FETCH_ONE}}
+{{#STMT_LAZY}}
+        ++m_fetchCount;
+{{/STMT_LAZY}}
 
         {{#DBENGINE_TRANSACTION}}
         {{DBENGINE_TRANSACTION_ROLLBACK}}
@@ -246,11 +300,31 @@ void {{CLASSNAME}}::close()
     }
 }
 
-bool {{CLASSNAME}}::fetchRow()
+bool {{CLASSNAME}}::fetchStep()
 {
+{{#STMT_LAZY}}
+    ++m_fetchCount;
+{{/STMT_LAZY}}
     {{DBENGINE_FETCH_SELECT}}
 }
 
+size_t {{CLASSNAME}}::rowCountHint()
+{
+    {{DBENGINE_ROW_COUNT_SELECT}}
+}
+
+bool {{CLASSNAME}}::fetchRow()
+{
+    if ( fetchStep() )
+    {
+        m_currentRow.reset( new _row_type( this{{#STMT_LAZY}}, m_lazyRows{{/STMT_LAZY}} ));
+        return true;
+    }
+
+    m_currentRow.reset();
+    return false;
+}
+
 {{CLASSNAME}}::iterator & {{CLASSNAME}}::begin()
 {
     ASSERT_MSG(m_selectIsActive, "Select is not active.  Ensure open() was called.");
@@ -266,6 +340,170 @@ bool {{CLASSNAME}}::fetchRow()
     else
         return s_endIterator;
 }
+
+{{CLASSNAME}}::row_vector {{CLASSNAME}}::fetchAll()
+{
+    ASSERT_MSG(m_selectIsActive, "Select is not active.  Ensure open() was called.");
+    ASSERT_MSG(!m_iterator, "fetchAll() called after begin().");
+
+    row_vector result;
+    result.reserve( rowCountHint() );
+
+    while ( fetchStep() )
+        result.push_back( _row_type( this ));
+
+    return result;
+}
+
+{{CLASSNAME}}::row_index {{CLASSNAME}}::fetchIndex()
+{
+    ASSERT_MSG(m_selectIsActive, "Select is not active.  Ensure open() was called.");
+    ASSERT_MSG(!m_iterator, "fetchIndex() called after begin().");
+
+    row_index result;
+    result.m_rows.reserve( rowCountHint() );
+
+    while ( fetchStep() )
+        result.m_rows.push_back( _row_type( this ));
+
+    std::stable_sort( result.m_rows.begin(), result.m_rows.end(), row_index::key_compare() );
+
+    return result;
+}
+
+{{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_STREAM}}
+size_t {{CLASSNAME}}::length{{STMT_OUT_FIELD_NAME}}()
+{
+    ASSERT_MSG(m_currentRow, "length{{STMT_OUT_FIELD_NAME}}() called without a current row.");
+
+    {{STMT_OUT_FIELD_STREAM_LENGTH}}
+}
+
+size_t {{CLASSNAME}}::read{{STMT_OUT_FIELD_NAME}}(char *_buffer, size_t _length, size_t _offset)
+{
+    ASSERT_MSG(m_currentRow, "read{{STMT_OUT_FIELD_NAME}}() called without a current row.");
+
+    {{STMT_OUT_FIELD_STREAM_READ}}
+}
+
+{{/STMT_OUT_FIELD_STREAM}}{{/STMT_OUT_FIELDS}}{{#STMT_PAGINATE}}bool {{CLASSNAME}}::fetchPage(row_vector& _page)
+{
+    ASSERT_MSG(!m_iterator, "fetchPage() called after begin().");
+
+    _page.clear();
+    if ( m_pageDone )
+        return false;
+
+    if ( m_pageNext )
+        open( {{#STMT_IN_FIELDS}}m_page{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+
+    ASSERT_MSG(m_selectIsActive, "fetchPage() called before open().");
+
+    _page.reserve( {{STMT_PAGE_SIZE}} );
+    while ( _page.size() < {{STMT_PAGE_SIZE}} && fetchStep() )
+        _page.push_back( _row_type( this ));
+
+    // Only a full page can be followed by another one
+    m_pageNext = _page.size() == {{STMT_PAGE_SIZE}};
+    m_pageDone = !m_pageNext;
+
+    if ( _page.empty() )
+        return false;
+
+    m_page{{STMT_PAGE_KEY_PARAM}} = _page.back().get{{STMT_OUT_KEY_FIELD_NAME}}();
+    return true;
+}
+
+{{/STMT_PAGINATE}}{{#STMT_FETCH_ONE}}bool {{CLASSNAME}}::fetchOne(_row_type& _row)
+{
+    bool found = fetchStep();
+    if ( found )
+        _row = _row_type( this );
+
+    // Releases the result, and whatever it holds on the connection, now;
+    // _row owns its copy.  The next open() must not reset it again
+    {{DBENGINE_RESET_SELECT}}
+    m_selectIsActive = false;
+    m_selectIsReset = true;
+    return found;
+}
+
+{{/STMT_FETCH_ONE}}{{CLASSNAME}}::columns {{CLASSNAME}}::fetchColumns()
+{
+    ASSERT_MSG(m_selectIsActive, "Select is not active.  Ensure open() was called.");
+    ASSERT_MSG(!m_iterator, "fetchColumns() called after begin().");
+
+    columns result;
+
+    while ( fetchStep() )
+    {
+        _row_type current( this );
+
+        {{#STMT_OUT_FIELDS}}result.{{STMT_OUT_FIELD_NAME}}.push_back( current.get{{STMT_OUT_FIELD_NAME}}(), current.isNull{{STMT_OUT_FIELD_NAME}}() );
+        {{/STMT_OUT_FIELDS}}
+        ++result.rows;
+    }
+
+    return result;
+}
+{{#ARROW}}
+std::shared_ptr<arrow::Schema> {{CLASSNAME}}::arrowSchema()
+{
+    return arrow::schema({
+        {{#STMT_OUT_FIELDS}}arrow::field("{{STMT_OUT_FIELD_NAME}}", {{STMT_OUT_FIELD_ARROW_TYPE}}){{STMT_OUT_FIELD_COMMA}}
+        {{/STMT_OUT_FIELDS}}
+    });
+}
+
+arrow::Result< std::vector< std::shared_ptr<arrow::RecordBatch> > > {{CLASSNAME}}::fetchArrowBatches(int64_t _batchRows, arrow::MemoryPool* _pool)
+{
+    ASSERT_MSG(m_selectIsActive, "Select is not active.  Ensure open() was called.");
+    ASSERT_MSG(!m_iterator, "fetchArrowBatches() called after begin().");
+
+    std::vector< std::shared_ptr<arrow::RecordBatch> > result;
+    std::shared_ptr<arrow::Schema> schema = arrowSchema();
+
+    // Columns are read from the driver's buffers as the row constructor
+    // would, without building a row
+    {{CLASSNAME}} *_parent = this;
+
+    {{#STMT_OUT_FIELDS}}{{STMT_OUT_FIELD_ARROW_BUILDER}} builder{{STMT_OUT_FIELD_NAME}}( {{STMT_OUT_FIELD_ARROW_TYPE}}, _pool );{{#STMT_OUT_FIELD_STREAM}}
+    std::vector<char> stream{{STMT_OUT_FIELD_NAME}};{{/STMT_OUT_FIELD_STREAM}}
+    {{/STMT_OUT_FIELDS}}
+
+    bool more = true;
+    while ( more )
+    {
+        int64_t rows = 0;
+
+        while ( rows < _batchRows && (more = fetchStep()) )
+        {
+            {{#STMT_OUT_FIELDS}}if ( {{STMT_OUT_FIELD_ISNULL}} )
+                ARROW_RETURN_NOT_OK( builder{{STMT_OUT_FIELD_NAME}}.AppendNull() );
+            else
+            {
+                {{STMT_OUT_FIELD_ARROW_READ}}
+                ARROW_RETURN_NOT_OK( dbbinderArrowAppend( builder{{STMT_OUT_FIELD_NAME}}, {{STMT_OUT_FIELD_ARROW_VALUE}} ));
+            }
+            {{/STMT_OUT_FIELDS}}
+            ++rows;
+        }
+
+        if ( rows == 0 )
+            break;
+
+        std::vector< std::shared_ptr<arrow::Array> > arrays;
+        std::shared_ptr<arrow::Array> array;
+
+        {{#STMT_OUT_FIELDS}}ARROW_RETURN_NOT_OK( builder{{STMT_OUT_FIELD_NAME}}.Finish( &array ));
+        arrays.push_back( array );
+        {{/STMT_OUT_FIELDS}}
+        result.push_back( arrow::RecordBatch::Make( schema, rows, arrays ));
+    }
+
+    return result;
+}
+{{/ARROW}}
 /* End Select Block */
 {{/SELECT}}
 {{#UPDATE}}
@@ -277,8 +515,7 @@ void {{CLASSNAME}}::update(
             {{/STMT_IN_FIELDS}})
 
 {
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
-    {{BUFFER_ALLOC}}
+    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_ALLOC}}
     {{/STMT_IN_FIELDS_BUFFERS}}
 
     {{#STMT_OUT_FIELDS_BUFFERS}}{{BUFFER_ALLOC}}
@@ -289,19 +526,35 @@ void {{CLASSNAME}}::update(
 
     {{DBENGINE_EXECUTE_UPDATE}}
     {{DBENGINE_RESET_UPDATE}}
-}
+}{{#STMT_MANY}}
+
+void {{CLASSNAME}}::updateChunk(const std::vector<update_args>& _rows)
+{
+    {{#STMT_IN_FIELDS}}std::vector< {{STMT_IN_FIELD_LIST_TYPE}} > _{{STMT_IN_FIELD_NAME}};
+    _{{STMT_IN_FIELD_NAME}}.reserve( _rows.size() );
+    {{/STMT_IN_FIELDS}}
+    for (size_t i = 0; i < _rows.size(); ++i)
+    {
+        {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}.push_back( _rows[i].{{STMT_IN_FIELD_NAME}} );
+        {{/STMT_IN_FIELDS}}
+    }
+
+    if ( !m_updateMany )
+        m_updateMany.reset( new {{STMT_MANY_CLASSNAME}}( m_conn ));
+
+    m_updateMany->update( {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+}{{/STMT_MANY}}
 /* End Update Block */
 {{/UPDATE}}
 {{#INSERT}}
 /* Insert Block */
 const int {{CLASSNAME}}::s_insertParamCount = {{STMT_PARAM_COUNT}};
 
-void {{CLASSNAME}}::insert(
+void {{CLASSNAME}}::{{STMT_INSERT_METHOD}}(
             {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}
             {{/STMT_IN_FIELDS}})
 {
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
-    {{BUFFER_ALLOC}}
+    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_ALLOC}}
     {{/STMT_IN_FIELDS_BUFFERS}}
 
     {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_BIND}}
@@ -320,8 +573,7 @@ void {{CLASSNAME}}::del(
             {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}
             {{/STMT_IN_FIELDS}})
 {
-    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
-    {{BUFFER_ALLOC}}
+    {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_ALLOC}}
     {{/STMT_IN_FIELDS_BUFFERS}}
 
     {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_BIND}}
@@ -329,9 +581,29 @@ void {{CLASSNAME}}::del(
 
     {{DBENGINE_EXECUTE_DELETE}}
     {{DBENGINE_RESET_DELETE}}
-}
+}{{#STMT_MANY}}
+
+void {{CLASSNAME}}::delChunk(const std::vector<del_args>& _rows)
+{
+    {{#STMT_IN_FIELDS}}std::vector< {{STMT_IN_FIELD_LIST_TYPE}} > _{{STMT_IN_FIELD_NAME}};
+    _{{STMT_IN_FIELD_NAME}}.reserve( _rows.size() );
+    {{/STMT_IN_FIELDS}}
+    for (size_t i = 0; i < _rows.size(); ++i)
+    {
+        {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}.push_back( _rows[i].{{STMT_IN_FIELD_NAME}} );
+        {{/STMT_IN_FIELDS}}
+    }
+
+    if ( !m_delMany )
+        m_delMany.reset( new {{STMT_MANY_CLASSNAME}}( m_conn ));
+
+    m_delMany->del( {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+}{{/STMT_MANY}}
 /* end Delete Block */
 {{/DELETE}}
+{{#STMT_BATCH}}
+const int {{CLASSNAME}}::s_batchSize = {{DBENGINE_BATCH_SIZE}};
+{{/STMT_BATCH}}
 {{#SPROC}}
 /* SProc Block */
 
@@ -420,11 +692,23 @@ void {{CLASSNAME}}::close()
     }
 }
 
-bool {{CLASSNAME}}::fetchRow()
+bool {{CLASSNAME}}::fetchStep()
 {
     {{DBENGINE_FETCH_SPROC}}
 }
 
+bool {{CLASSNAME}}::fetchRow()
+{
+    if ( fetchStep() )
+    {
+        m_currentRow.reset( new _row_type( this ));
+        return true;
+    }
+
+    m_currentRow.reset();
+    return false;
+}
+
 {{CLASSNAME}}::iterator & {{CLASSNAME}}::begin()
 {
     ASSERT_MSG(m_sprocIsActive, "Select is not active.  Ensure open() was called.");
@@ -9,8 +9,12 @@
 
 #include <boost/shared_ptr.hpp>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string.h>
 #include <libgen.h>
+#include <unistd.h>
 
 {{#DBENGINE_INCLUDES}}{{DBENGINE_INCLUDE_NAME}}
 {{/DBENGINE_INCLUDES}}
@@ -20,6 +24,89 @@
 {{#NAMESPACES}}namespace {{NAMESPACE}} {
 {{/NAMESPACES}}
 
+#ifndef __DBBINDER_ERRORS
+#define __DBBINDER_ERRORS
+namespace DBBinder
+{
+/**
+ * Base of every exception thrown by the generated code. code() is the native
+ * engine error (SQLite result code, MySQL errno, libpq result status, ISC
+ * status or ORA number) and sqlState() the SQLSTATE when the engine has one.
+ */
+class Error: public std::runtime_error
+{
+    private:
+        int         m_code;
+        std::string m_sqlState;
+
+    public:
+        Error(int _code, const std::string& _sqlState, const std::string& _what)
+            : std::runtime_error(_what), m_code(_code), m_sqlState(_sqlState) {}
+        virtual ~Error() throw() {}
+
+        int code() const { return m_code; }
+        const std::string& sqlState() const { return m_sqlState; }
+        virtual bool retryable() const { return false; }
+};
+
+/**
+ * Transient failure (busy database, lock conflict, deadlock, lost
+ * connection): the same unit of work may succeed if it is repeated.
+ */
+class RetryableError: public Error
+{
+    public:
+        RetryableError(int _code, const std::string& _sqlState, const std::string& _what)
+            : Error(_code, _sqlState, _what) {}
+
+        virtual bool retryable() const { return true; }
+};
+
+/**
+ * Failure that will happen again on retry: constraint violations, syntax
+ * errors, type mismatches, misuse of the API.
+ */
+class FatalError: public Error
+{
+    public:
+        FatalError(int _code, const std::string& _sqlState, const std::string& _what)
+            : Error(_code, _sqlState, _what) {}
+};
+
+/**
+ * Calls _fn until it returns, as long as it throws RetryableError and fewer
+ * than _attempts calls were made; waits _delayMs between calls, doubling it
+ * each time. The last error is rethrown. _fn must redo the whole unit of
+ * work: after a lost connection that means reconnecting and recreating the
+ * statement objects, which are bound to the old connection.
+ */
+template<typename F>
+void retry(F _fn, unsigned _attempts = 3, unsigned _delayMs = 10)
+{
+    for (unsigned attempt = 1; ; ++attempt)
+    {
+        try
+        {
+            _fn();
+            return;
+        }
+        catch (const RetryableError&)
+        {
+            if (attempt >= _attempts)
+                throw;
+        }
+
+        usleep(_delayMs * 1000);
+        _delayMs *= 2;
+    }
+}
+}
+
+#define DBBINDER_THROW(_retryable, _code, _sqlState, _msg) do { std::ostringstream __dbbinderMsg; __dbbinderMsg << _msg; \
+    if (_retryable) throw DBBinder::RetryableError(_code, _sqlState, __dbbinderMsg.str()); \
+    throw DBBinder::FatalError(_code, _sqlState, __dbbinderMsg.str()); } while (false)
+#endif // __DBBINDER_ERRORS
+
 namespace DBBinder
 {
 
@@ -11,14 +11,38 @@
 #include <boost/shared_ptr.hpp>
 #else
 #include <memory>
+#include <chrono>
+#include <type_traits>
+#endif
+#if __cplusplus >= 201703L
+#include <optional>
 #endif
 
+{{#PTIME}}
 #include <boost/date_time/posix_time/posix_time_types.hpp>
+{{/PTIME}}
+{{#PARALLEL_SCAN}}
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <exception>
+#include <thread>
+#endif
+{{/PARALLEL_SCAN}}
 
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cassert>
+#include <string>
 #include <string.h>
+#include <stdint.h>
 #include <libgen.h>
+#include <unistd.h>
 #include <vector>
+#include <algorithm>
+{{#ARROW}}
+#include <arrow/api.h>
+{{/ARROW}}
 
 {{#DBENGINE_INCLUDES}}{{DBENGINE_INCLUDE_NAME}}
 {{/DBENGINE_INCLUDES}}
@@ -32,7 +56,9 @@
 {{#EXTRA_HEADERS}}{{EXTRA_HEADERS_TYPE}}
 {{/EXTRA_HEADERS}}
 
+{{#PTIME}}
 using boost::posix_time::ptime;
+{{/PTIME}}
 
 #ifdef NDEBUG
 #ifndef ASSERT_MSG
@@ -50,11 +76,719 @@ using boost::posix_time::ptime;
 #endif
 #endif
 
+#ifndef __DBBINDER_ERRORS
+#define __DBBINDER_ERRORS
+namespace DBBinder
+{
+/**
+ * Base of every exception thrown by the generated code. code() is the native
+ * engine error (SQLite result code, MySQL errno, libpq result status, ISC
+ * status or ORA number) and sqlState() the SQLSTATE when the engine has one.
+ */
+class Error: public std::runtime_error
+{
+    private:
+        int         m_code;
+        std::string m_sqlState;
+
+    public:
+        Error(int _code, const std::string& _sqlState, const std::string& _what)
+            : std::runtime_error(_what), m_code(_code), m_sqlState(_sqlState) {}
+        virtual ~Error() throw() {}
+
+        int code() const { return m_code; }
+        const std::string& sqlState() const { return m_sqlState; }
+        virtual bool retryable() const { return false; }
+};
+
+/**
+ * Transient failure (busy database, lock conflict, deadlock, lost
+ * connection): the same unit of work may succeed if it is repeated.
+ */
+class RetryableError: public Error
+{
+    public:
+        RetryableError(int _code, const std::string& _sqlState, const std::string& _what)
+            : Error(_code, _sqlState, _what) {}
+
+        virtual bool retryable() const { return true; }
+};
+
+/**
+ * Failure that will happen again on retry: constraint violations, syntax
+ * errors, type mismatches, misuse of the API.
+ */
+class FatalError: public Error
+{
+    public:
+        FatalError(int _code, const std::string& _sqlState, const std::string& _what)
+            : Error(_code, _sqlState, _what) {}
+};
+
+/**
+ * Calls _fn until it returns, as long as it throws RetryableError and fewer
+ * than _attempts calls were made; waits _delayMs between calls, doubling it
+ * each time. The last error is rethrown. _fn must redo the whole unit of
+ * work: after a lost connection that means reconnecting and recreating the
+ * statement objects, which are bound to the old connection.
+ */
+template<typename F>
+void retry(F _fn, unsigned _attempts = 3, unsigned _delayMs = 10)
+{
+    for (unsigned attempt = 1; ; ++attempt)
+    {
+        try
+        {
+            _fn();
+            return;
+        }
+        catch (const RetryableError&)
+        {
+            if (attempt >= _attempts)
+                throw;
+        }
+
+        usleep(_delayMs * 1000);
+        _delayMs *= 2;
+    }
+}
+}
+
+#define DBBINDER_THROW(_retryable, _code, _sqlState, _msg) do { std::ostringstream __dbbinderMsg; __dbbinderMsg << _msg; \
+    if (_retryable) throw DBBinder::RetryableError(_code, _sqlState, __dbbinderMsg.str()); \
+    throw DBBinder::FatalError(_code, _sqlState, __dbbinderMsg.str()); } while (false)
+#endif // __DBBINDER_ERRORS
+
+#ifndef __DBBINDER_DECIMAL
+#define __DBBINDER_DECIMAL
+/**
+ * Exact fixed point number, value() / 10^scale(). A scaled 64 bit integer:
+ * 18 significant digits without heap allocation or binary rounding. Values
+ * that don't fit throw a FatalError (SQLSTATE 22003) instead of wrapping.
+ */
+class DBBinderDecimal
+{
+    public:
+        // sign, 20 digits, point and '\0'
+        enum { STRING_SIZE = 24 };
+
+        DBBinderDecimal():
+            m_value(0), m_scale(0)
+        {}
+
+        DBBinderDecimal(int64_t _value, int _scale = 0):
+            m_value(_value), m_scale(_scale)
+        {}
+
+        int64_t value() const
+        {
+            return m_value;
+        }
+
+        int scale() const
+        {
+            return m_scale;
+        }
+
+        // Same number with _scale decimals, truncated when _scale is smaller
+        DBBinderDecimal rescale(int _scale) const
+        {
+            int64_t value = m_value;
+            if (!scaleUp(value, _scale - m_scale))
+                DBBINDER_THROW(false, 0, "22003", "Decimal overflow: " << str() << " with " << _scale << " decimals");
+            for (int scale = m_scale; scale > _scale; --scale)
+                value /= 10;
+
+            return DBBinderDecimal(value, _scale);
+        }
+
+        double toDouble() const
+        {
+            double divisor = 1;
+            for (int scale = 0; scale < m_scale; ++scale)
+                divisor *= 10;
+
+            return m_value / divisor;
+        }
+
+        // "[-]digits[.digits]", as sent by the text protocols
+        static DBBinderDecimal parse(const char* _str, size_t _length)
+        {
+            const char *end = _str + _length;
+            int64_t value = 0;
+            int scale = -1;
+            bool negative = false;
+
+            if (_str != end && (*_str == '-' || *_str == '+'))
+                negative = *_str++ == '-';
+
+            for (const char *digit = _str; digit != end; ++digit)
+            {
+                if (*digit == '.')
+                    scale = 0;
+                else if (*digit >= '0' && *digit <= '9')
+                {
+                    if (!scaleUp(value, 1) || value > INT64_MAX - (*digit - '0'))
+                        DBBINDER_THROW(false, 0, "22003", "Decimal overflow: " << std::string(_str, end - _str));
+
+                    value += *digit - '0';
+                    if (scale >= 0)
+                        ++scale;
+                }
+                else
+                    break;
+            }
+
+            return DBBinderDecimal(negative ? -value : value, scale < 0 ? 0 : scale);
+        }
+
+        static DBBinderDecimal parse(const char* _str)
+        {
+            return parse(_str, _str ? strlen(_str) : 0);
+        }
+
+        // Writes the number to _buffer, which must hold STRING_SIZE chars
+        char* format(char* _buffer) const
+        {
+            char *p = _buffer + STRING_SIZE;
+            uint64_t value = m_value < 0 ? 0 - static_cast<uint64_t>(m_value) : m_value;
+            int digits = 0;
+
+            *--p = '\0';
+            do
+            {
+                if (digits == m_scale && digits)
+                    *--p = '.';
+                *--p = static_cast<char>('0' + value % 10);
+                value /= 10;
+                ++digits;
+            }
+            while (value || digits <= m_scale);
+
+            if (m_value < 0)
+                *--p = '-';
+
+            memmove(_buffer, p, _buffer + STRING_SIZE - p);
+            return _buffer;
+        }
+
+        std::string str() const
+        {
+            char buffer[STRING_SIZE];
+            return format(buffer);
+        }
+
+        bool operator==(const DBBinderDecimal& _other) const
+        {
+            return compare(_other) == 0;
+        }
+
+        bool operator!=(const DBBinderDecimal& _other) const
+        {
+            return !(*this == _other);
+        }
+
+        bool operator<(const DBBinderDecimal& _other) const
+        {
+            return compare(_other) < 0;
+        }
+
+        DBBinderDecimal operator+(const DBBinderDecimal& _other) const
+        {
+            int scale = std::max(m_scale, _other.m_scale);
+            int64_t left = rescale(scale).m_value, right = _other.rescale(scale).m_value;
+
+            if (right > 0 ? left > INT64_MAX - right : left < INT64_MIN - right)
+                DBBINDER_THROW(false, 0, "22003", "Decimal overflow: " << str() << " + " << _other.str());
+
+            return DBBinderDecimal(left + right, scale);
+        }
+
+        DBBinderDecimal operator-(const DBBinderDecimal& _other) const
+        {
+            int scale = std::max(m_scale, _other.m_scale);
+            int64_t left = rescale(scale).m_value, right = _other.rescale(scale).m_value;
+
+            if (right < 0 ? left > INT64_MAX + right : left < INT64_MIN + right)
+                DBBINDER_THROW(false, 0, "22003", "Decimal overflow: " << str() << " - " << _other.str());
+
+            return DBBinderDecimal(left - right, scale);
+        }
+
+        DBBinderDecimal& operator+=(const DBBinderDecimal& _other)
+        {
+            return *this = *this + _other;
+        }
+
+        // Multiplies _value by 10^_times; false, _value unchanged, on overflow
+        static bool scaleUp(int64_t& _value, int _times)
+        {
+            int64_t value = _value;
+            for (; _times > 0; --_times)
+            {
+                if (value > INT64_MAX / 10 || value < INT64_MIN / 10)
+                    return false;
+                value *= 10;
+            }
+
+            _value = value;
+            return true;
+        }
+
+    private:
+        // Sign of *this - _other. The value with fewer decimals is scaled up,
+        // and when that overflows it is the larger in magnitude
+        int compare(const DBBinderDecimal& _other) const
+        {
+            int64_t left = m_value, right = _other.m_value;
+
+            if (!scaleUp(left, _other.m_scale - m_scale))
+                return left < 0 ? -1 : 1;
+            if (!scaleUp(right, m_scale - _other.m_scale))
+                return right < 0 ? 1 : -1;
+
+            return left < right ? -1 : left > right;
+        }
+
+        int64_t m_value;
+        int     m_scale;
+};
+
+inline std::ostream& operator<<(std::ostream& _stream, const DBBinderDecimal& _value)
+{
+    char buffer[DBBinderDecimal::STRING_SIZE];
+    return _stream << _value.format(buffer);
+}
+#endif
+
+#ifndef __DBBINDER_TIME
+#define __DBBINDER_TIME
+/**
+ * Engines hand dates and times over as microseconds since 1970-01-01 UTC (a
+ * time of day as microseconds since midnight). The dbbinderFromMicros and
+ * dbbinderToMicros overloads convert that to the type setType() picked for
+ * timestamp, date and time: an integer, a std::chrono::time_point (such as
+ * sys_time<microseconds>), a std::chrono::duration for times, or ptime.
+ */
+inline int64_t dbbinderDaysFromCivil(int _year, unsigned _month, unsigned _day)
+{
+    _year -= _month <= 2;
+    const int era = (_year >= 0 ? _year : _year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(_year - era * 400);
+    const unsigned doy = (153 * (_month > 2 ? _month - 3 : _month + 9) + 2) / 5 + _day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int64_t>(era) * 146097 + doe - 719468;
+}
+
+inline void dbbinderCivilFromDays(int64_t _days, int& _year, unsigned& _month, unsigned& _day)
+{
+    _days += 719468;
+    const int64_t era = (_days >= 0 ? _days : _days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(_days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    _day = doy - (153 * mp + 2) / 5 + 1;
+    _month = mp < 10 ? mp + 3 : mp - 9;
+    _year = static_cast<int>(yoe + era * 400 + (_month <= 2));
+}
+
+inline void dbbinderFromMicros(int64_t _micros, long& _value)
+{
+    _value = _micros;
+}
+
+inline void dbbinderFromMicros(int64_t _micros, long long& _value)
+{
+    _value = _micros;
+}
+
+inline int64_t dbbinderToMicros(long _value)
+{
+    return _value;
+}
+
+inline int64_t dbbinderToMicros(long long _value)
+{
+    return _value;
+}
+
+// Only ptime has a "no value" state of its own
+template<typename T>
+inline bool dbbinderTimeIsNull(const T&)
+{
+    return false;
+}
+
+#if __cplusplus >= 201103L
+template<typename C, typename D>
+inline void dbbinderFromMicros(int64_t _micros, std::chrono::time_point<C, D>& _value)
+{
+    _value = std::chrono::time_point<C, D>(std::chrono::duration_cast<D>(std::chrono::microseconds(_micros)));
+}
+
+template<typename C, typename D>
+inline int64_t dbbinderToMicros(const std::chrono::time_point<C, D>& _value)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(_value.time_since_epoch()).count();
+}
+
+template<typename R, typename P>
+inline void dbbinderFromMicros(int64_t _micros, std::chrono::duration<R, P>& _value)
+{
+    _value = std::chrono::duration_cast<std::chrono::duration<R, P> >(std::chrono::microseconds(_micros));
+}
+
+template<typename R, typename P>
+inline int64_t dbbinderToMicros(const std::chrono::duration<R, P>& _value)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(_value).count();
+}
+#endif
+#endif // __DBBINDER_TIME
+{{#PTIME}}
+
+#ifndef __DBBINDER_TIME_PTIME
+#define __DBBINDER_TIME_PTIME
+inline void dbbinderFromMicros(int64_t _micros, ptime& _value)
+{
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    _value = epoch + boost::posix_time::microseconds(_micros);
+}
+
+inline int64_t dbbinderToMicros(const ptime& _value)
+{
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (_value - epoch).total_microseconds();
+}
+
+inline bool dbbinderTimeIsNull(const ptime& _value)
+{
+    return _value.is_not_a_date_time();
+}
+#endif // __DBBINDER_TIME_PTIME
+{{/PTIME}}
+
+#ifndef __DBBINDER_TEXT
+#define __DBBINDER_TEXT
+/**
+ * Owned copy of a const char* text value. Rows keep their text in one, so
+ * a row stays valid after the statement steps past it, is reset or closed:
+ * engines hand text over as pointers into their own buffers. Params kept
+ * for a later call (fetchPage(), the *_args structs) are copied the same
+ * way, as the caller's string may be gone by then.  Converts back to
+ * const char*, NULL included.
+ */
+class DBBinderText
+{
+    public:
+        DBBinderText(const char* _value = NULL)
+        {
+            assign(_value);
+        }
+
+        DBBinderText& operator=(const char* _value)
+        {
+            assign(_value);
+            return *this;
+        }
+
+        operator const char*() const
+        {
+            return c_str();
+        }
+
+        const char* c_str() const
+        {
+            return m_isNull ? NULL : m_value.c_str();
+        }
+
+    private:
+        std::string m_value;
+        bool        m_isNull;
+
+        void assign(const char* _value)
+        {
+            m_isNull = !_value;
+            if ( _value )
+                m_value.assign(_value);
+            else
+                m_value.clear();
+        }
+};
+#endif // __DBBINDER_TEXT
+
+#ifndef __DBBINDER_LISTS
+#define __DBBINDER_LISTS
+/**
+ * List params ("--! param ids int[]") reach engines without array binds as
+ * one JSON array text, unpacked by the statement itself (SQLite's
+ * json_each(), MySQL's JSON_TABLE()), so any number of values share the
+ * one prepared statement.
+ */
+template<typename T>
+inline void dbbinderJSONValue(std::ostream& _str, const T& _value)
+{
+    _str << _value;
+}
+
+inline void dbbinderJSONValue(std::ostream& _str, const char* _value)
+{
+    if ( !_value )
+    {
+        _str << "null";
+        return;
+    }
+
+    _str << '"';
+    for (; *_value; ++_value)
+    {
+        unsigned char c = static_cast<unsigned char>(*_value);
+        if ( c == '"' || c == '\\' )
+            _str << '\\' << *_value;
+        else if ( c < 0x20 )
+        {
+            static const char hex[] = "0123456789abcdef";
+            _str << "\\u00" << hex[c >> 4] << hex[c & 15];
+        }
+        else
+            _str << *_value;
+    }
+    _str << '"';
+}
+
+inline void dbbinderJSONValue(std::ostream& _str, const std::string& _value)
+{
+    dbbinderJSONValue(_str, _value.c_str());
+}
+
+template<typename T>
+inline void dbbinderJSONArray(std::string& _buff, const std::vector<T>& _values)
+{
+    std::ostringstream str;
+    str.precision(17);
+
+    str << '[';
+    for (size_t i = 0; i < _values.size(); ++i)
+        dbbinderJSONValue(i ? str << ',' : str, _values[i]);
+    str << ']';
+
+    _buff = str.str();
+}
+#endif // __DBBINDER_LISTS
+
 {{#DBENGINE_GLOBAL_FUNCTIONS}}
 {{FUNCTION}}
 {{/DBENGINE_GLOBAL_FUNCTIONS}}
 
+#ifndef __DBBINDER_KEY_LESS
+#define __DBBINDER_KEY_LESS
+template<typename T>
+inline bool dbbinderKeyLess(const T& _a, const T& _b)
+{
+    return _a < _b;
+}
+
+inline bool dbbinderKeyLess(const char* _a, const char* _b)
+{
+    return strcmp(_a ? _a : "", _b ? _b : "") < 0;
+}
+#endif
+
+#ifndef __DBBINDER_COLUMNS
+#define __DBBINDER_COLUMNS
+/**
+ * Validity bitmap, least significant bit first: bit i is set when
+ * value i is not NULL.
+ */
+class DBBinderBitmap
+{
+    public:
+        DBBinderBitmap():
+            m_size(0)
+        {}
+
+        void push_back(bool _isNull)
+        {
+            if ( (m_size & 7) == 0 )
+                m_bits.push_back(0);
+
+            if ( !_isNull )
+                m_bits.back() |= static_cast<unsigned char>(1 << (m_size & 7));
+
+            ++m_size;
+        }
+
+        bool isNull(size_t _index) const
+        {
+            return !(m_bits[_index >> 3] & (1 << (_index & 7)));
+        }
+
+        const unsigned char* data() const
+        {
+            return m_bits.empty() ? NULL : &m_bits[0];
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+    private:
+        std::vector<unsigned char>  m_bits;
+        size_t                      m_size;
+};
+
+template<typename T>
+struct DBBinderColumn
+{
+    std::vector<T>  values;
+    DBBinderBitmap  validity;
+
+    void push_back(const T& _value, bool _isNull)
+    {
+        values.push_back(_value);
+        validity.push_back(_isNull);
+    }
+
+    bool isNull(size_t _index) const
+    {
+        return validity.isNull(_index);
+    }
+
+    size_t size() const
+    {
+        return values.size();
+    }
+};
+
+/**
+ * Variable length column: value i is bytes[offsets[i]] up to
+ * bytes[offsets[i + 1]], not NUL terminated.
+ */
+struct DBBinderTextColumn
+{
+    DBBinderTextColumn():
+        offsets(1, 0)
+    {}
+
+    std::vector<int32_t>    offsets;
+    std::vector<char>       bytes;
+    DBBinderBitmap          validity;
+
+    void push_back(const char* _value, bool _isNull)
+    {
+        append(_value, _value ? strlen(_value) : 0, _isNull);
+    }
+
+    void push_back(const std::string& _value, bool _isNull)
+    {
+        append(_value.data(), _value.size(), _isNull);
+    }
+
+    // Blobs: any pointer to a std::vector<char>
+    template<typename P>
+    void push_back(const P& _blob, bool _isNull)
+    {
+        if ( _blob && !_blob->empty() )
+            append(&(*_blob)[0], _blob->size(), _isNull);
+        else
+            append(NULL, 0, _isNull);
+    }
+
+    void append(const char* _data, size_t _length, bool _isNull)
+    {
+        bytes.insert(bytes.end(), _data, _data + _length);
+        offsets.push_back(static_cast<int32_t>(bytes.size()));
+        validity.push_back(_isNull);
+    }
+
+    const char* data(size_t _index) const
+    {
+        return bytes.empty() ? NULL : &bytes[offsets[_index]];
+    }
+
+    size_t length(size_t _index) const
+    {
+        return offsets[_index + 1] - offsets[_index];
+    }
+
+    std::string str(size_t _index) const
+    {
+        return std::string(data(_index), length(_index));
+    }
+
+    bool isNull(size_t _index) const
+    {
+        return validity.isNull(_index);
+    }
+
+    size_t size() const
+    {
+        return offsets.size() - 1;
+    }
+};
+#endif
+{{#ARROW}}
+#ifndef __DBBINDER_ARROW
+#define __DBBINDER_ARROW
+template<typename B, typename T>
+inline arrow::Status dbbinderArrowAppend(B& _builder, const T& _value)
+{
+    return _builder.Append(_value);
+}
+
+inline arrow::Status dbbinderArrowAppend(arrow::StringBuilder& _builder, const char* _value)
+{
+    return _builder.Append(_value ? _value : "", static_cast<int32_t>(_value ? strlen(_value) : 0));
+}
+
+inline arrow::Status dbbinderArrowAppend(arrow::StringBuilder& _builder, const DBBinderDecimal& _value)
+{
+    char buffer[DBBinderDecimal::STRING_SIZE];
+    return _builder.Append(_value.format(buffer));
+}
+
+template<typename C, typename D>
+inline arrow::Status dbbinderArrowAppend(arrow::TimestampBuilder& _builder, const std::chrono::time_point<C, D>& _value)
+{
+    return _builder.Append(dbbinderToMicros(_value));
+}
+{{#PTIME}}
+
+inline arrow::Status dbbinderArrowAppend(arrow::TimestampBuilder& _builder, const ptime& _value)
+{
+    return _builder.Append(dbbinderToMicros(_value));
+}
+{{/PTIME}}
+
+// Streamed columns, read whole into a scratch vector
+inline arrow::Status dbbinderArrowAppend(arrow::BinaryBuilder& _builder, const std::vector<char>& _data)
+{
+    return _builder.Append(reinterpret_cast<const uint8_t*>(_data.empty() ? NULL : &_data[0]), static_cast<int32_t>(_data.size()));
+}
+
+inline arrow::Status dbbinderArrowAppend(arrow::StringBuilder& _builder, const std::vector<char>& _data)
+{
+    return dbbinderArrowAppend(static_cast<arrow::BinaryBuilder&>(_builder), _data);
+}
+
+// Blobs: any pointer to a std::vector<char>
+template<typename P>
+inline arrow::Status dbbinderArrowAppend(arrow::BinaryBuilder& _builder, const P& _blob)
+{
+    if ( _blob && !_blob->empty() )
+        return _builder.Append(reinterpret_cast<const uint8_t*>(&(*_blob)[0]), static_cast<int32_t>(_blob->size()));
+
+    return _builder.Append(static_cast<const uint8_t*>(NULL), 0);
+}
+#endif
+{{/ARROW}}
+
 {{#CLASS}}
+{{#UPDATE}}{{#STMT_MANY}}
+class {{STMT_MANY_CLASSNAME}};{{/STMT_MANY}}{{/UPDATE}}{{#DELETE}}{{#STMT_MANY}}
+class {{STMT_MANY_CLASSNAME}};{{/STMT_MANY}}{{/DELETE}}
 
 /**
  * @class {{CLASSNAME}}
@@ -112,14 +846,29 @@ class {{CLASSNAME}}
     private:
         static const char* const s_selectSQL;
         static const int         s_selectSQL_len;
+        static const char* const s_selectName;    // prepared statement name, unique across namespaces
         static const int         s_selectFieldCount;
         static const int         s_selectParamCount;
 
         {{DBENGINE_STATEMENT_TYPE}} m_selectStmt;
-        bool                        m_selectIsActive;
+        bool                        m_selectIsActive;{{#STMT_FETCH_ONE}}
+        // fetchOne() already reset the select, close() still has to destroy it
+        bool                        m_selectIsReset;{{/STMT_FETCH_ONE}}
 
+        bool fetchStep();
         bool fetchRow();
-
+        size_t rowCountHint();
+{{#STMT_LAZY}}
+        // Rows fetched so far, lazy rows only decode while it is unchanged
+        unsigned long               m_fetchCount;
+        // Cleared by fetchAll<T>() and map_begin(), whose rows outlive the cursor
+        bool                        m_lazyRows;
+{{/STMT_LAZY}}{{#STMT_PAGINATE}}
+        // open() arguments, replayed with the last key for the next page
+        {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_MEMBER_TYPE}} m_page{{STMT_IN_FIELD_NAME}};
+        {{/STMT_IN_FIELDS}}bool                        m_pageNext;
+        bool                        m_pageDone;
+{{/STMT_PAGINATE}}
         {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
         {{/STMT_IN_FIELDS_BUFFERS}}
         {{#STMT_OUT_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
@@ -127,25 +876,126 @@ class {{CLASSNAME}}
     public:
         void open( {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}} );
         void close();
+{{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_ENUM}}
+        /**
+        * Values of {{STMT_OUT_FIELD_NAME}}, in the order the column declares them.
+        */
+#if __cplusplus >= 201103L
+        enum class {{STMT_OUT_FIELD_ENUM_TYPE}} : {{STMT_OUT_FIELD_ENUM_BASE}}
+        {
+            {{STMT_OUT_FIELD_ENUM_VALUES}}
+        };
+#else
+        struct {{STMT_OUT_FIELD_ENUM_TYPE}}
+        {
+            enum type
+            {
+                {{STMT_OUT_FIELD_ENUM_VALUES}}
+            };
+
+            {{STMT_OUT_FIELD_ENUM_TYPE}}(type _value = type()): m_value(_value) {}
+            explicit {{STMT_OUT_FIELD_ENUM_TYPE}}(int _value): m_value(static_cast<{{STMT_OUT_FIELD_ENUM_BASE}}>(_value)) {}
+            operator type() const { return static_cast<type>(m_value); }
+
+            private:
+                {{STMT_OUT_FIELD_ENUM_BASE}} m_value;
+        };
+#endif
 
+        static const char* const* {{STMT_OUT_FIELD_ENUM_TYPE}}Names()
+        {
+            static const char* const names[] = { {{STMT_OUT_FIELD_ENUM_NAMES}} };
+            return names;
+        }
+
+        static const char* toString({{STMT_OUT_FIELD_ENUM_TYPE}} _value)
+        {
+            return {{STMT_OUT_FIELD_ENUM_TYPE}}Names()[static_cast<int>(_value)];
+        }
+
+        /**
+        * @return false, leaving _value alone, for a label the column didn't declare
+        */
+        static bool fromString(const char* _str, {{STMT_OUT_FIELD_ENUM_TYPE}}& _value)
+        {
+            const char* const* names = {{STMT_OUT_FIELD_ENUM_TYPE}}Names();
+            for (int i = 0; i < {{STMT_OUT_FIELD_ENUM_COUNT}}; ++i)
+                if (strcmp(names[i], _str) == 0)
+                {
+                    _value = static_cast<{{STMT_OUT_FIELD_ENUM_TYPE}}>(i);
+                    return true;
+                }
+            return false;
+        }
+{{/STMT_OUT_FIELD_ENUM}}{{/STMT_OUT_FIELDS}}
+
+        /**
+        * A row by value: copyable, and with the implicit (noexcept) move
+        * constructor, so vectors of rows move them when growing.  Text is
+        * copied in, so a row stays valid once the statement moved past it.{{#STMT_LAZY}}
+        *
+        * Rows from begin()/++ are lazy: each getter decodes its column on
+        * first use, from the statement's current row, and throws once the
+        * statement moved past it.  Read what you need before moving on, or
+        * copy the iterator: that decodes its row whole.  Rows from either
+        * fetchAll(), fetchIndex(), fetchColumns() and map_begin() are
+        * decoded whole.{{/STMT_LAZY}}
+        */
         class _row_type
         {
             friend class {{CLASSNAME}};
 
-            private:
+            public:
                 _row_type():
-                {{#STMT_OUT_FIELDS}}m_{{STMT_OUT_FIELD_NAME}}({{STMT_OUT_FIELD_INIT}}){{STMT_OUT_FIELD_COMMA}}{{/STMT_OUT_FIELDS}}
+                {{#STMT_OUT_FIELDS_PACKED}}m_{{STMT_OUT_FIELD_NAME}}({{STMT_OUT_FIELD_INIT}}),
+                {{/STMT_OUT_FIELDS_PACKED}}m_isNull(){{#STMT_LAZY}},
+                m_parent(NULL),
+                m_fetchCount(0),
+                m_decoded(){{/STMT_LAZY}}
                 {}
 
-                _row_type({{CLASSNAME}} *_parent)
+            private:
+                _row_type({{CLASSNAME}} *_parent{{#STMT_LAZY}}, bool _lazy = false{{/STMT_LAZY}}):
+                    {{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_STREAM}}m_{{STMT_OUT_FIELD_NAME}}(),
+                    {{/STMT_OUT_FIELD_STREAM}}{{/STMT_OUT_FIELDS}}m_isNull(){{#STMT_LAZY}},
+                    m_parent(_parent),
+                    m_fetchCount(_parent->m_fetchCount),
+                    m_decoded(){{/STMT_LAZY}}
                 {
-                    {{#STMT_OUT_FIELDS}}m_isNull{{STMT_OUT_FIELD_NAME}} = {{STMT_OUT_FIELD_ISNULL}};
-                    {{STMT_OUT_FIELD_GETVALUE}}{{/STMT_OUT_FIELDS}}
+                    {{#STMT_OUT_FIELDS}}if ( {{STMT_OUT_FIELD_ISNULL}} )
+                        m_isNull[{{STMT_OUT_FIELD_NULL_BYTE}}] |= {{STMT_OUT_FIELD_NULL_MASK}};
+                    {{STMT_OUT_FIELD_GETVALUE}}
+                    {{/STMT_OUT_FIELDS}}{{#STMT_LAZY}}
+                    if ( !_lazy )
+                        decodeAll();{{/STMT_LAZY}}
                 }
 
-                {{#STMT_OUT_FIELDS}}{{STMT_OUT_FIELD_TYPE}} m_{{STMT_OUT_FIELD_NAME}};
-                bool m_isNull{{STMT_OUT_FIELD_NAME}};
-                {{/STMT_OUT_FIELDS}}
+                {{#STMT_OUT_FIELDS_PACKED}}{{#STMT_OUT_FIELD_LAZY}}mutable {{/STMT_OUT_FIELD_LAZY}}{{STMT_OUT_FIELD_TYPE}} m_{{STMT_OUT_FIELD_NAME}};
+                {{/STMT_OUT_FIELDS_PACKED}}
+                unsigned char m_isNull[{{STMT_OUT_NULL_BYTES}}];{{#STMT_LAZY}}
+
+                // Statement the columns are still read from, NULL once decoded
+                {{CLASSNAME}} *m_parent;
+                unsigned long m_fetchCount;
+                mutable unsigned char m_decoded[{{STMT_OUT_NULL_BYTES}}];
+
+                void decodeAll()
+                {
+                    {{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_LAZY}}if ( !(m_decoded[{{STMT_OUT_FIELD_NULL_BYTE}}] & {{STMT_OUT_FIELD_NULL_MASK}}) )
+                        decode{{STMT_OUT_FIELD_NAME}}();
+                    {{/STMT_OUT_FIELD_LAZY}}{{/STMT_OUT_FIELDS}}m_parent = NULL;
+                }
+                {{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_LAZY}}
+                void decode{{STMT_OUT_FIELD_NAME}}() const
+                {
+                    if ( m_fetchCount != m_parent->m_fetchCount )
+                        DBBINDER_THROW( false, 0, "", "get{{STMT_OUT_FIELD_NAME}}() of a lazy row called after the statement moved past it." );
+
+                    {{CLASSNAME}} *_parent = m_parent;
+                    {{STMT_OUT_FIELD_GETVALUE}}
+                    m_decoded[{{STMT_OUT_FIELD_NULL_BYTE}}] |= {{STMT_OUT_FIELD_NULL_MASK}};
+                }
+                {{/STMT_OUT_FIELD_LAZY}}{{/STMT_OUT_FIELDS}}{{/STMT_LAZY}}
             public:
                 {{#STMT_OUT_FIELDS}}
                 /**
@@ -154,18 +1004,26 @@ class {{CLASSNAME}}
                 */
                 {{STMT_OUT_FIELD_TYPE}} get{{STMT_OUT_FIELD_NAME}}() const
                 {
-                    return m_{{STMT_OUT_FIELD_NAME}};
+                    {{#STMT_OUT_FIELD_LAZY}}if ( m_parent && !(m_decoded[{{STMT_OUT_FIELD_NULL_BYTE}}] & {{STMT_OUT_FIELD_NULL_MASK}}) )
+                        decode{{STMT_OUT_FIELD_NAME}}();
+
+                    {{/STMT_OUT_FIELD_LAZY}}return m_{{STMT_OUT_FIELD_NAME}};
                 }
 
                 bool isNull{{STMT_OUT_FIELD_NAME}}() const
                 {
-                    return m_isNull{{STMT_OUT_FIELD_NAME}};
+                    return (m_isNull[{{STMT_OUT_FIELD_NULL_BYTE}}] & {{STMT_OUT_FIELD_NULL_MASK}}) != 0;
                 }
                 {{/STMT_OUT_FIELDS}}
         };
+#if __cplusplus >= 201103L
+        static_assert( std::is_nothrow_move_constructible<_row_type>::value,
+                       "{{CLASSNAME}}::_row_type must move without throwing, or row vectors copy it when growing" );
+#endif
 
         typedef {{STMT_OUT_KEY_FIELD_TYPE}} key_type;
         typedef shared_pointer<_row_type>::type row;
+        typedef std::vector<_row_type> row_vector;
 
         class iterator
         {
@@ -179,16 +1037,20 @@ class {{CLASSNAME}}
                     m_row( _parent->m_currentRow )
                 {}
 
+                // A copy may keep the row after this one moved on
                 iterator(const iterator& other):
                     m_parent( other.m_parent ),
                     m_row( other.m_row )
-                {}
+                {
+                    {{#STMT_LAZY}}detach();
+                {{/STMT_LAZY}}}
 
                 void operator=(const iterator& other)
                 {
                     m_row = other.m_row;
                     m_parent = other.m_parent;
-                }
+                    {{#STMT_LAZY}}detach();
+                {{/STMT_LAZY}}}
 
             protected:
                 {{CLASSNAME}}* m_parent;
@@ -199,6 +1061,13 @@ class {{CLASSNAME}}
                     m_parent->fetchRow();
                     m_row = m_parent->m_currentRow;
                 }
+{{#STMT_LAZY}}
+                void detach()
+                {
+                    if ( m_row && m_row->m_parent )
+                        m_row->decodeAll();
+                }
+{{/STMT_LAZY}}
             public:
                 const row& operator*() const
                 {
@@ -293,7 +1162,8 @@ class {{CLASSNAME}}
 
         map_iterator map_begin()
         {
-            return map_iterator(begin());
+            {{#STMT_LAZY}}m_lazyRows = false;
+            {{/STMT_LAZY}}return map_iterator(begin());
         }
 
         map_iterator map_end()
@@ -306,17 +1176,346 @@ class {{CLASSNAME}}
             return begin() == end();
         }
 
-        std::vector<row> fetchAll()
-        {
-            return fetchAll< std::vector<row> >();
-        }
+        /**
+        * Reads the remaining rows, by value, into a single vector; reserved up
+        * front when the engine knows the row count.  Must be called instead
+        * of begin(), not after it.
+        */
+        row_vector fetchAll();
 
+        /**
+        * Fills any container constructible from an iterator range of row.
+        */
         template<typename T>
         T fetchAll()
         {
-            return T(begin(), end());
+            {{#STMT_LAZY}}m_lazyRows = false;
+            {{/STMT_LAZY}}return T(begin(), end());
+        }
+
+        /**
+        * Flat lookup table of rows, stored by value and sorted by key_type.
+        * Text keys are compared with strcmp.
+        */
+        class row_index
+        {
+            friend class {{CLASSNAME}};
+
+            public:
+                typedef std::vector<_row_type>              container_type;
+                typedef container_type::const_iterator      const_iterator;
+
+                const_iterator begin() const
+                {
+                    return m_rows.begin();
+                }
+
+                const_iterator end() const
+                {
+                    return m_rows.end();
+                }
+
+                size_t size() const
+                {
+                    return m_rows.size();
+                }
+
+                bool empty() const
+                {
+                    return m_rows.empty();
+                }
+
+                /**
+                * @return the first row with key _key, or end()
+                */
+                const_iterator find(const key_type& _key) const
+                {
+                    const_iterator it = std::lower_bound(m_rows.begin(), m_rows.end(), _key, key_compare());
+
+                    if ( it != m_rows.end() && !dbbinderKeyLess(_key, it->get{{STMT_OUT_KEY_FIELD_NAME}}()) )
+                        return it;
+
+                    return m_rows.end();
+                }
+
+                std::pair<const_iterator, const_iterator> equal_range(const key_type& _key) const
+                {
+                    return std::equal_range(m_rows.begin(), m_rows.end(), _key, key_compare());
+                }
+
+            private:
+                struct key_compare
+                {
+                    bool operator()(const _row_type& _a, const _row_type& _b) const
+                    {
+                        return dbbinderKeyLess(_a.get{{STMT_OUT_KEY_FIELD_NAME}}(), _b.get{{STMT_OUT_KEY_FIELD_NAME}}());
+                    }
+
+                    bool operator()(const _row_type& _row, const key_type& _key) const
+                    {
+                        return dbbinderKeyLess(_row.get{{STMT_OUT_KEY_FIELD_NAME}}(), _key);
+                    }
+
+                    bool operator()(const key_type& _key, const _row_type& _row) const
+                    {
+                        return dbbinderKeyLess(_key, _row.get{{STMT_OUT_KEY_FIELD_NAME}}());
+                    }
+                };
+
+                container_type m_rows;
+        };
+
+        /**
+        * Reads the remaining rows into a row_index.  Must be called
+        * instead of begin(), not after it.
+        */
+        row_index fetchIndex();
+
+        /**
+        * Result set stored column by column, one contiguous array per field.
+        */
+        struct columns
+        {
+            columns():
+                rows(0)
+            {}
+
+            size_t rows;
+            {{#STMT_OUT_FIELDS}}{{STMT_OUT_FIELD_COLUMN_TYPE}} {{STMT_OUT_FIELD_NAME}};
+            {{/STMT_OUT_FIELDS}}
+        };
+
+        /**
+        * Reads the remaining rows into columns.  Must be called
+        * instead of begin(), not after it.
+        */
+        columns fetchColumns();
+{{#STMT_PAGINATE}}
+        /**
+        * Reads the next page, at most {{STMT_PAGE_SIZE}} rows, into _page.  Every page
+        * after the first executes the statement again with {{STMT_PAGE_KEY_PARAM}} set
+        * to the last key read, so the query must select the rows after it
+        * ordered by {{STMT_OUT_KEY_FIELD_NAME}}, and is best limited to {{STMT_PAGE_SIZE}} rows.
+        * The other open() arguments are kept as passed.  Must be called
+        * instead of begin(), not after it.
+        * @return false, with _page empty, after the last page
+        */
+        bool fetchPage(row_vector& _page);
+
+        /**
+        * {{STMT_OUT_KEY_FIELD_NAME}} of the last row fetchPage() returned: open() with it
+        * as {{STMT_PAGE_KEY_PARAM}} resumes reading after that row.
+        */
+        key_type lastKey() const
+        {
+            return m_page{{STMT_PAGE_KEY_PARAM}};
         }
 
+        /**
+        * Input iterator over the pages of fetchPage(), from pages() to pages_end().
+        */
+        class page_iterator
+        {
+            public:
+                page_iterator():
+                    m_parent(NULL)
+                {}
+
+                explicit page_iterator({{CLASSNAME}}* _parent):
+                    m_parent( _parent )
+                {
+                    ++*this;
+                }
+
+                const row_vector& operator*() const
+                {
+                    ASSERT_MSG( m_parent, "Called operator* after the last page." );
+                    return m_page;
+                }
+
+                const row_vector* operator->() const
+                {
+                    ASSERT_MSG( m_parent, "Called operator-> after the last page." );
+                    return &m_page;
+                }
+
+                page_iterator& operator++()
+                {
+                    ASSERT_MSG( m_parent, "Called operator++ after the last page." );
+                    if ( !m_parent->fetchPage( m_page ))
+                        m_parent = NULL;
+                    return *this;
+                }
+
+                bool operator==(const page_iterator& _other) const
+                {
+                    return m_parent == _other.m_parent;
+                }
+
+                bool operator!=(const page_iterator& _other) const
+                {
+                    return m_parent != _other.m_parent;
+                }
+
+                typedef std::input_iterator_tag iterator_category;
+                typedef row_vector value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const row_vector* pointer;
+                typedef const row_vector& reference;
+
+            private:
+                {{CLASSNAME}}* m_parent;
+                row_vector m_page;
+        };
+
+        page_iterator pages()
+        {
+            return page_iterator(this);
+        }
+
+        page_iterator pages_end()
+        {
+            return page_iterator();
+        }
+{{/STMT_PAGINATE}}{{#STMT_PARTITION}}
+#if __cplusplus >= 201103L
+        /**
+        * Reads the rows with _low <= {{STMT_OUT_KEY_FIELD_NAME}} < _high in parallel, split in
+        * _partitions key ranges of about the same width.  There is a worker
+        * thread per connection of _pool, at most _partitions, each reading
+        * the next unread range until none is left.  _callback(const _row_type&)
+        * is called concurrently from the workers, so it must be thread safe.
+        * The first exception of a worker or of _callback ends the scan and is
+        * rethrown here, once every worker stopped.  Needs -pthread.
+        */
+        template<typename F>
+        static void parallelScan(const std::vector<{{DBENGINE_CONNECTION_TYPE}}>& _pool, int _partitions, F _callback,
+                                 key_type _low, key_type _high{{#STMT_IN_FIELDS}}{{#STMT_IN_FIELD_SCAN_PARAM}},
+                                 {{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{/STMT_IN_FIELD_SCAN_PARAM}}{{/STMT_IN_FIELDS}})
+        {
+            ASSERT_MSG( !_pool.empty() && _partitions > 0, "parallelScan() needs connections and partitions." );
+
+            if ( !(_low < _high) )
+                return;
+
+            // Width of the key range, exact for any signed or unsigned key
+            const uint64_t span = static_cast<uint64_t>(_high) - static_cast<uint64_t>(_low);
+            const uint64_t count = static_cast<uint64_t>(_partitions);
+            auto bound = [&](uint64_t _partition)
+            {
+                return static_cast<key_type>(static_cast<uint64_t>(_low) + span / count * _partition + std::min(_partition, span % count));
+            };
+
+            const size_t workers = std::min<size_t>(_pool.size(), _partitions);
+            std::atomic<int> next(0);
+            std::atomic<bool> failed(false);
+            std::vector<std::exception_ptr> errors(workers);
+            std::vector<std::thread> threads;
+
+            for (size_t worker = 0; worker < workers; ++worker)
+                threads.push_back(std::thread([&, worker]()
+                {
+                    try
+                    {
+                        {{CLASSNAME}} select(_pool[worker]);
+
+                        for (int partition = next++; partition < _partitions && !failed; partition = next++)
+                        {
+                            key_type from = bound(partition);
+                            key_type to = bound(partition + 1);
+
+                            select.open( {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_SCAN_ARG}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+                            while ( !failed && select.fetchStep() )
+                                _callback( _row_type( &select ));
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[worker] = std::current_exception();
+                        failed = true;
+                    }
+                }));
+
+            for (size_t worker = 0; worker < workers; ++worker)
+                threads[worker].join();
+
+            for (size_t worker = 0; worker < workers; ++worker)
+                if ( errors[worker] )
+                    std::rethrow_exception( errors[worker] );
+        }
+#endif
+{{/STMT_PARTITION}}{{#STMT_SINGLE}}
+        /**
+        * Executes the statement and reads its first row into _row, on the
+        * stack: no iterator, no shared row.  The statement is reset before
+        * returning.  Must not be called after begin().
+        * @return false, leaving _row alone, when there is no row
+        */
+        bool get({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}, {{/STMT_IN_FIELDS}}_row_type& _row)
+        {
+            ASSERT_MSG(!m_iterator, "get() called after begin().");
+
+            open( {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+            return fetchOne( _row );
+        }
+
+#if __cplusplus >= 201703L
+        std::optional<_row_type> get({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}})
+        {
+            _row_type row;
+            if ( get( {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}, {{/STMT_IN_FIELDS}}row ))
+                return row;
+
+            return std::nullopt;
+        }
+#endif
+{{/STMT_SINGLE}}{{#STMT_SCALAR}}
+        /**
+        * Executes the statement and returns {{STMT_SCALAR_NAME}} of its first row, or
+        * the default value when there is none.  The statement is reset before
+        * returning.  Must not be called after begin().{{#STMT_SCALAR_TEXT}}
+        * Text is returned as a copy, empty for NULL.{{/STMT_SCALAR_TEXT}}
+        */
+        {{STMT_SCALAR_TYPE}} value({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}})
+        {
+            ASSERT_MSG(!m_iterator, "value() called after begin().");
+
+            _row_type row;
+            open( {{#STMT_IN_FIELDS}}_{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}} {{/STMT_IN_FIELDS}});
+            fetchOne( row );
+            {{#STMT_SCALAR_TEXT}}const char* text = row.get{{STMT_SCALAR_NAME}}();
+            return text ? text : "";{{/STMT_SCALAR_TEXT}}{{#STMT_SCALAR_PLAIN}}return row.get{{STMT_SCALAR_NAME}}();{{/STMT_SCALAR_PLAIN}}
+        }
+{{/STMT_SCALAR}}{{#STMT_FETCH_ONE}}
+    private:
+        bool fetchOne(_row_type& _row);
+
+    public:
+{{/STMT_FETCH_ONE}}{{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_STREAM}}
+        /**
+        * {{STMT_OUT_FIELD_NAME}} is streamed: rows don't copy it, it is read
+        * from the current row (the one begin()/++ last moved to) instead.
+        * @return size of {{STMT_OUT_FIELD_NAME}} in bytes
+        */
+        size_t length{{STMT_OUT_FIELD_NAME}}();
+
+        /**
+        * Copies at most _length bytes of {{STMT_OUT_FIELD_NAME}}, starting at
+        * _offset, into _buffer.
+        * @return the number of bytes copied, 0 once _offset reaches the end
+        */
+        size_t read{{STMT_OUT_FIELD_NAME}}(char *_buffer, size_t _length, size_t _offset);
+{{/STMT_OUT_FIELD_STREAM}}{{/STMT_OUT_FIELDS}}
+{{#ARROW}}
+        static std::shared_ptr<arrow::Schema> arrowSchema();
+
+        /**
+        * Reads the remaining rows into Arrow record batches of at most
+        * _batchRows rows each.  Must be called instead of begin(), not after it.
+        */
+        arrow::Result< std::vector< std::shared_ptr<arrow::RecordBatch> > > fetchArrowBatches(int64_t _batchRows, arrow::MemoryPool* _pool = arrow::default_memory_pool());
+{{/ARROW}}
+
     private:
         row             m_currentRow;
         iterator        *m_iterator;
@@ -326,29 +1525,150 @@ class {{CLASSNAME}}
     private:
         static const char* const        s_updateSQL;
         static const int                s_updateSQL_len;
+        static const char* const        s_updateName;
         static const int                s_updateParamCount;
         {{DBENGINE_STATEMENT_TYPE}}     m_updateStmt;
+
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
     public:
         void update({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}});
-{{/UPDATE}}
+{{#STMT_MANY}}
+        /**
+        * The params of one {{CLASSNAME}}::update() call, for updateMany().
+        */
+        struct update_args
+        {
+            update_args({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}}){{#STMT_HAS_PARAMS}}:
+                {{/STMT_HAS_PARAMS}}{{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_NAME}}( _{{STMT_IN_FIELD_NAME}} ){{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}}
+            {}
+
+            {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_MEMBER_TYPE}} {{STMT_IN_FIELD_NAME}};
+            {{/STMT_IN_FIELDS}}
+        };
+
+        /**
+        * Does what update() does for each element of [_first, _last), anything
+        * update_args converts from, as one set-based statement per s_batchSize
+        * elements: {{STMT_MANY_CLASSNAME}}, taking each param as a list.
+        * Each statement succeeds or fails as a whole; open a transaction first
+        * to make the whole range so.  Elements are expected to match distinct
+        * rows: which of two elements matching the same row applies is up to the
+        * database.
+        * @return the number of elements
+        */
+        template<typename InputIterator>
+        size_t updateMany(InputIterator _first, InputIterator _last)
+        {
+            std::vector<update_args> rows;
+            size_t count = 0;
+
+            while ( _first != _last )
+            {
+                rows.clear();
+                for (; rows.size() < size_t(s_batchSize) && _first != _last; ++_first)
+                    rows.push_back( *_first );
+
+                updateChunk( rows );
+                count += rows.size();
+            }
+
+            return count;
+        }
+
+        template<typename Range>
+        size_t updateMany(const Range& _range)
+        {
+            return updateMany( _range.begin(), _range.end() );
+        }
+
+    private:
+        shared_pointer<{{STMT_MANY_CLASSNAME}}>::type m_updateMany;
+
+        void updateChunk(const std::vector<update_args>& _rows);
+{{/STMT_MANY}}{{/UPDATE}}
 {{#INSERT}}
     private:
         static const char* const        s_insertSQL;
         static const int                s_insertSQL_len;
+        static const char* const        s_insertName;
         static const int                s_insertParamCount;
         {{DBENGINE_STATEMENT_TYPE}}     m_insertStmt;
+
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
     public:
-        void insert({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}});
+        void {{STMT_INSERT_METHOD}}({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}});
 {{/INSERT}}
 {{#DELETE}}
     private:
         static const char* const        s_deleteSQL;
         static const int                s_deleteSQL_len;
+        static const char* const        s_deleteName;
         static const int                s_deleteParamCount;
         {{DBENGINE_STATEMENT_TYPE}}     m_deleteStmt;
+
+        {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
+        {{/STMT_IN_FIELDS_BUFFERS}}
     public:
         void del({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}});
-{{/DELETE}}
+{{#STMT_MANY}}
+        /**
+        * The params of one {{CLASSNAME}}::del() call, for delMany().
+        */
+        struct del_args
+        {
+            del_args({{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}}){{#STMT_HAS_PARAMS}}:
+                {{/STMT_HAS_PARAMS}}{{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_NAME}}( _{{STMT_IN_FIELD_NAME}} ){{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}}
+            {}
+
+            {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_MEMBER_TYPE}} {{STMT_IN_FIELD_NAME}};
+            {{/STMT_IN_FIELDS}}
+        };
+
+        /**
+        * Does what del() does for each element of [_first, _last), anything
+        * del_args converts from, as one set-based statement per s_batchSize
+        * elements: {{STMT_MANY_CLASSNAME}}, taking each param as a list.
+        * Each statement succeeds or fails as a whole; open a transaction first
+        * to make the whole range so.  Elements are expected to match distinct
+        * rows: which of two elements matching the same row applies is up to the
+        * database.
+        * @return the number of elements
+        */
+        template<typename InputIterator>
+        size_t delMany(InputIterator _first, InputIterator _last)
+        {
+            std::vector<del_args> rows;
+            size_t count = 0;
+
+            while ( _first != _last )
+            {
+                rows.clear();
+                for (; rows.size() < size_t(s_batchSize) && _first != _last; ++_first)
+                    rows.push_back( *_first );
+
+                delChunk( rows );
+                count += rows.size();
+            }
+
+            return count;
+        }
+
+        template<typename Range>
+        size_t delMany(const Range& _range)
+        {
+            return delMany( _range.begin(), _range.end() );
+        }
+
+    private:
+        shared_pointer<{{STMT_MANY_CLASSNAME}}>::type m_delMany;
+
+        void delChunk(const std::vector<del_args>& _rows);
+{{/STMT_MANY}}{{/DELETE}}{{#STMT_BATCH}}
+    private:
+        static const int s_batchSize;
+{{/STMT_BATCH}}
 {{#SPROC}}
     public:
         {{#STMT_HAS_PARAMS}}
@@ -359,12 +1679,14 @@ class {{CLASSNAME}}
     private:
         static const char* const s_sprocSQL;
         static const int         s_sprocSQL_len;
+        static const char* const s_sprocName;
         static const int         s_sprocFieldCount;
         static const int         s_sprocParamCount;
 
         {{DBENGINE_STATEMENT_TYPE}} m_sprocStmt;
         bool                        m_sprocIsActive;
 
+        bool fetchStep();
         bool fetchRow();
 
         {{#STMT_IN_FIELDS_BUFFERS}}{{BUFFER_DECLARE}}
@@ -374,6 +1696,58 @@ class {{CLASSNAME}}
     public:
         void execute( {{#STMT_IN_FIELDS}}{{STMT_IN_FIELD_TYPE}} _{{STMT_IN_FIELD_NAME}}{{STMT_IN_FIELD_COMMA}}{{/STMT_IN_FIELDS}} );
         void close();
+{{#STMT_OUT_FIELDS}}{{#STMT_OUT_FIELD_ENUM}}
+        /**
+        * Values of {{STMT_OUT_FIELD_NAME}}, in the order the column declares them.
+        */
+#if __cplusplus >= 201103L
+        enum class {{STMT_OUT_FIELD_ENUM_TYPE}} : {{STMT_OUT_FIELD_ENUM_BASE}}
+        {
+            {{STMT_OUT_FIELD_ENUM_VALUES}}
+        };
+#else
+        struct {{STMT_OUT_FIELD_ENUM_TYPE}}
+        {
+            enum type
+            {
+                {{STMT_OUT_FIELD_ENUM_VALUES}}
+            };
+
+            {{STMT_OUT_FIELD_ENUM_TYPE}}(type _value = type()): m_value(_value) {}
+            explicit {{STMT_OUT_FIELD_ENUM_TYPE}}(int _value): m_value(static_cast<{{STMT_OUT_FIELD_ENUM_BASE}}>(_value)) {}
+            operator type() const { return static_cast<type>(m_value); }
+
+            private:
+                {{STMT_OUT_FIELD_ENUM_BASE}} m_value;
+        };
+#endif
+
+        static const char* const* {{STMT_OUT_FIELD_ENUM_TYPE}}Names()
+        {
+            static const char* const names[] = { {{STMT_OUT_FIELD_ENUM_NAMES}} };
+            return names;
+        }
+
+        static const char* toString({{STMT_OUT_FIELD_ENUM_TYPE}} _value)
+        {
+            return {{STMT_OUT_FIELD_ENUM_TYPE}}Names()[static_cast<int>(_value)];
+        }
+
+        /**
+        * @return false, leaving _value alone, for a label the column didn't declare
+        */
+        static bool fromString(const char* _str, {{STMT_OUT_FIELD_ENUM_TYPE}}& _value)
+        {
+            const char* const* names = {{STMT_OUT_FIELD_ENUM_TYPE}}Names();
+            for (int i = 0; i < {{STMT_OUT_FIELD_ENUM_COUNT}}; ++i)
+                if (strcmp(names[i], _str) == 0)
+                {
+                    _value = static_cast<{{STMT_OUT_FIELD_ENUM_TYPE}}>(i);
+                    return true;
+                }
+            return false;
+        }
+{{/STMT_OUT_FIELD_ENUM}}{{/STMT_OUT_FIELDS}}
 
         class _row_type
         {
@@ -381,18 +1755,22 @@ class {{CLASSNAME}}
 
             private:
                 _row_type():
-                {{#STMT_OUT_FIELDS}}m_{{STMT_OUT_FIELD_NAME}}({{STMT_OUT_FIELD_INIT}}){{STMT_OUT_FIELD_COMMA}}{{/STMT_OUT_FIELDS}}
+                {{#STMT_OUT_FIELDS_PACKED}}m_{{STMT_OUT_FIELD_NAME}}({{STMT_OUT_FIELD_INIT}}),
+                {{/STMT_OUT_FIELDS_PACKED}}m_isNull()
                 {}
 
-                _row_type({{CLASSNAME}} *_parent)
+                _row_type({{CLASSNAME}} *_parent):
+                    m_isNull()
                 {
-                    {{#STMT_OUT_FIELDS}}m_isNull{{STMT_OUT_FIELD_NAME}} = {{STMT_OUT_FIELD_ISNULL}};
-                    {{STMT_OUT_FIELD_GETVALUE}}{{/STMT_OUT_FIELDS}}
+                    {{#STMT_OUT_FIELDS}}if ( {{STMT_OUT_FIELD_ISNULL}} )
+                        m_isNull[{{STMT_OUT_FIELD_NULL_BYTE}}] |= {{STMT_OUT_FIELD_NULL_MASK}};
+                    {{STMT_OUT_FIELD_GETVALUE}}
+                    {{/STMT_OUT_FIELDS}}
                 }
 
-                {{#STMT_OUT_FIELDS}}{{STMT_OUT_FIELD_TYPE}} m_{{STMT_OUT_FIELD_NAME}};
-                bool m_isNull{{STMT_OUT_FIELD_NAME}};
-                {{/STMT_OUT_FIELDS}}
+                {{#STMT_OUT_FIELDS_PACKED}}{{STMT_OUT_FIELD_TYPE}} m_{{STMT_OUT_FIELD_NAME}};
+                {{/STMT_OUT_FIELDS_PACKED}}
+                unsigned char m_isNull[{{STMT_OUT_NULL_BYTES}}];
             public:
                 {{#STMT_OUT_FIELDS}}
                 /**
@@ -406,7 +1784,7 @@ class {{CLASSNAME}}
 
                 bool isNull{{STMT_OUT_FIELD_NAME}}() const
                 {
-                    return m_isNull{{STMT_OUT_FIELD_NAME}};
+                    return (m_isNull[{{STMT_OUT_FIELD_NULL_BYTE}}] & {{STMT_OUT_FIELD_NULL_MASK}}) != 0;
                 }
                 {{/STMT_OUT_FIELDS}}
         };
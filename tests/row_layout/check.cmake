@@ -0,0 +1,25 @@
+# Row members are declared widest first, whatever the column order of the
+# select (Active, Qty, Name, Price, Id).
+
+file(MAKE_DIRECTORY ${BINARY_DIR})
+
+execute_process(COMMAND ${DBBINDER} --template-dir ${TEMPLATE_DIR}
+                        -i ${SOURCE_DIR}/layout.sql -o ${BINARY_DIR}/layout
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "dbbinder failed: ${result}")
+endif()
+
+file(READ ${BINARY_DIR}/layout.h header)
+
+set(previous -1)
+foreach(member "DBBinderText m_Name;" "int m_Qty;" "float m_Price;" "int m_Id;" "bool m_Active;")
+    string(FIND "${header}" "${member}" position)
+    if(position EQUAL -1)
+        message(FATAL_ERROR "'${member}' not declared")
+    endif()
+    if(NOT position GREATER previous)
+        message(FATAL_ERROR "'${member}' declared out of alignment order")
+    endif()
+    set(previous ${position})
+endforeach()
@@ -0,0 +1,4 @@
+--! use layout.yaml
+--! name selLayout
+
+select ACTIVE as Active, QTY as Qty, NAME as Name, PRICE as Price, ID as Id from ITEMS
@@ -0,0 +1,8 @@
+create table ITEMS
+(
+	ID		integer not null primary key,
+	ACTIVE	boolean,
+	QTY		integer,
+	PRICE	float,
+	NAME	text
+);
@@ -17,6 +17,8 @@
     along with DBBinder++.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <sstream>
+
 #include "TinyXML/nvXML.h"
 
 #include "main.h"
@@ -64,6 +66,7 @@ static void getXMLParams(XMLElementPtr _elem, AbstractElements* _elements)
     SQLTypes type;
     std::string name, defaultValue, strType;
     int index;
+    bool list;
 
     XMLElementPtr param;
     XMLNodePtr node = 0;
@@ -76,7 +79,7 @@ static void getXMLParams(XMLElementPtr _elem, AbstractElements* _elements)
         param->GetAttributeOrDefault( "default", &defaultValue, "" );
         param->GetAttributeOrDefault( "index", &index, -1 );
 
-        type = typeNameToSQLType(strType);
+        type = typeNameToSQLType(strType, list);
         if ( type == stUnknown )
         {
             WARNING("unknown param type for: " << name);
@@ -84,6 +87,7 @@ static void getXMLParams(XMLElementPtr _elem, AbstractElements* _elements)
         }
 
         _elements->input.push_back( SQLElement( name, type, index, defaultValue ));
+        _elements->input.back().list = list;
     }
 }
 
@@ -132,6 +136,26 @@ void parseXML(const std::string& _fileName)
             elem->GetAttribute( "name", &elements.name );
             getXMLParams( elem, &elements );
 
+            // paginate="<key field> <page size>"
+            std::string paginate;
+            elem->GetAttributeOrDefault( "paginate", &paginate, "" );
+            if ( !paginate.empty() )
+            {
+                std::istringstream str( paginate );
+                if ( !(str >> elements.keyFieldName >> elements.pageSize) || elements.pageSize < 1 )
+                    FATAL(fileName << ": " << elements.name << ": paginate expects a key field and a positive page size");
+            }
+
+            // partition="<key field> <low param> <high param>"
+            std::string partition;
+            elem->GetAttributeOrDefault( "partition", &partition, "" );
+            if ( !partition.empty() )
+            {
+                std::istringstream str( partition );
+                if ( !(str >> elements.keyFieldName >> elements.partitionLow >> elements.partitionHigh) )
+                    FATAL(fileName << ": " << elements.name << ": partition expects a key field and its low and high bound params");
+            }
+
             generator->addSelect( elements );
         }
 
@@ -156,7 +180,20 @@ void parseXML(const std::string& _fileName)
             elem->GetAttribute( "name", &elements.name );
             getXMLParams( elem, &elements );
 
-            generator->addInsert( elements );
+            // upsert="<key column>..."
+            std::string upsert;
+            elem->GetAttributeOrDefault( "upsert", &upsert, "" );
+            if ( upsert.empty() )
+                generator->addInsert( elements );
+            else
+            {
+                std::istringstream str( upsert );
+                std::string key;
+                while ( str >> key )
+                    elements.conflictKeys.push_back( key );
+
+                generator->addUpsert( elements );
+            }
         }
 
         node = 0;
@@ -19,6 +19,7 @@
 
 #include <errno.h>
 #include <yaml.h>
+#include <sstream>
 
 #include "main.h"
 #include "abstractgenerator.h"
@@ -152,6 +153,7 @@ static void getYAMLParams(yaml_parser_t &_parser, AbstractElements* _elements)
     SQLTypes type;
     std::string name, defaultValue, strType;
     int index;
+    bool list;
 
     while ( !done )
     {
@@ -174,6 +176,58 @@ static void getYAMLParams(yaml_parser_t &_parser, AbstractElements* _elements)
                 {
                     if ( attr == "sql" )
                         _elements->sql = value;
+                    else if ( attr == "upsert" )
+                    {
+                        // upsert: <key column>...
+                        if ( _elements->type != sstInsert )
+                        {
+                            WARNING(fileName << ": warning: ignoreing upsert for non-insert statement " << _elements->name);
+                        }
+                        else
+                        {
+                            InsertElements *insert = static_cast<InsertElements*>( _elements );
+                            std::istringstream str( value );
+                            std::string key;
+
+                            while ( str >> key )
+                                insert->conflictKeys.push_back( key );
+
+                            if ( insert->conflictKeys.empty() )
+                                sendYAMLError(_parser, "upsert expects its key columns");
+                        }
+                    }
+                    else if ( attr == "paginate" )
+                    {
+                        // paginate: <key field> <page size>
+                        if ( _elements->type != sstSelect )
+                        {
+                            WARNING(fileName << ": warning: ignoreing paginate for non-select statement " << _elements->name);
+                        }
+                        else
+                        {
+                            SelectElements *select = static_cast<SelectElements*>( _elements );
+                            std::istringstream str( value );
+
+                            if ( !(str >> select->keyFieldName >> select->pageSize) || select->pageSize < 1 )
+                                sendYAMLError(_parser, "paginate expects a key field and a positive page size");
+                        }
+                    }
+                    else if ( attr == "partition" )
+                    {
+                        // partition: <key field> <low param> <high param>
+                        if ( _elements->type != sstSelect )
+                        {
+                            WARNING(fileName << ": warning: ignoreing partition for non-select statement " << _elements->name);
+                        }
+                        else
+                        {
+                            SelectElements *select = static_cast<SelectElements*>( _elements );
+                            std::istringstream str( value );
+
+                            if ( !(str >> select->keyFieldName >> select->partitionLow >> select->partitionHigh) )
+                                sendYAMLError(_parser, "partition expects a key field and its low and high bound params");
+                        }
+                    }
                     else if ( attr == "include" )
                     {
                         std::string path( getFilenameRelativeTo(fileName, value) );
@@ -240,7 +294,7 @@ static void getYAMLParams(yaml_parser_t &_parser, AbstractElements* _elements)
                             yaml_event_delete(&event);
                         }
 
-                        type = typeNameToSQLType(strType);
+                        type = typeNameToSQLType(strType, list);
                         if ( type == stUnknown )
                         {
                             WARNING(fileName << ": warning: Unknown YAML event: " << event.type << " in params");
@@ -248,6 +302,7 @@ static void getYAMLParams(yaml_parser_t &_parser, AbstractElements* _elements)
                         }
 
                         _elements->input.push_back( SQLElement( name, type, index, defaultValue ));
+                        _elements->input.back().list = list;
                     }
 
                     attr.clear();
@@ -274,7 +329,11 @@ static void parseYAMLInsert(yaml_parser_t &_parser)
 {
     InsertElements elements;
     getYAMLParams( _parser, &elements );
-    AbstractGenerator::getGenerator()->addInsert( elements );
+
+    if ( elements.conflictKeys.empty() )
+        AbstractGenerator::getGenerator()->addInsert( elements );
+    else
+        AbstractGenerator::getGenerator()->addUpsert( elements );
 }
 
 static void parseYAMLUpdate(yaml_parser_t &_parser)